@@ -1,4 +1,5 @@
 #include "include/concurrency/safe_mutex.h"
+#include "include/concurrency/recursive_safe_mutex.h"
 
 #include <iostream>
 #include <thread>
@@ -96,7 +97,19 @@ void case3() {
     Mutex1.unlock(lockStory);
 }
 
+void case4() {
+    /* Re-entry of the same story is fine with RecursiveSafeMutex */
+    concurrency::RecursiveSafeMutex Mutex1;
+    concurrency::LockStory lockStory;
+
+    Mutex1.lock(lockStory);
+    Mutex1.lock(lockStory);
+    Mutex1.unlock(lockStory);
+    Mutex1.unlock(lockStory);
+}
+
 int main() {
     case1();
+    case4();
     return 0;
 }
@@ -0,0 +1,136 @@
+#ifndef CONCURRENCY_ASYNC_SAFE_MUTEX_H
+#define CONCURRENCY_ASYNC_SAFE_MUTEX_H
+
+#include "include/concurrency/safe_mutex.h"
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+
+namespace atom::concurrency {
+
+/**
+ * @brief Mutex for C++20 coroutines: a contended lock suspends the coroutine instead of blocking its thread.
+ * @details The mutex is a single atomic word: unlocked, locked without waiters, or the head of a LIFO stack of the
+ * awaiters pushed by the contended lock() calls. The awaiter lives in the coroutine frame for the time of the
+ * suspension, so queueing doesn't allocate. The holder moves the stack into its own FIFO list on unlock() and
+ * resumes the first waiter, which becomes the holder. The resumption runs inline on the thread that calls unlock(),
+ * and unlock() returns when that coroutine suspends or finishes. An unlock() called from a coroutine resumed this way
+ * doesn't resume the next waiter on top of it: it queues the waiter on the thread and returns, and the outermost
+ * unlock() resumes the queued waiters one after another. A chain of waiters which unlock right away thus runs in a
+ * loop at a constant stack depth.
+ *
+ * A coroutine may be resumed on another worker thread, so the thread-local LockStory::current() doesn't describe it:
+ * every task keeps its own LockStory and passes it to lock()/unlock(). In checked builds the story records the locks
+ * the task holds, and their order is checked in the global lock order graph as for SafeMutex. A lock order inversion
+ * between two tasks is therefore reported even when both tasks run on the same thread.
+ * The release build has no checks: the LockSampler tracks the held locks per thread, which means nothing for tasks.
+ * @example
+ *      AsyncSafeMutex mutex;
+ *
+ *      Task<void> append(LockStory& lockStory, Entry entry) {
+ *          auto guard = co_await mutex.scopedLock(lockStory);
+ *          journal.push_back(std::move(entry));
+ *      }
+ */
+class AsyncSafeMutex final {
+public:
+    /**
+     * @brief Awaitable of lock(), the coroutine holds the mutex when the co_await completes.
+     */
+    class LockAwaiter {
+    public:
+        explicit LockAwaiter(AsyncSafeMutex& mutex, LockStory& lockStory):
+        m_mutex(mutex),
+        m_lockStory(lockStory),
+        m_handle(),
+        m_next(nullptr) {}
+
+        bool await_ready();
+        bool await_suspend(std::coroutine_handle<> handle);
+        void await_resume();
+
+    protected:
+        AsyncSafeMutex& m_mutex;
+        LockStory& m_lockStory;
+
+    private:
+        friend AsyncSafeMutex;
+
+        std::coroutine_handle<> m_handle;
+        LockAwaiter* m_next;
+    };
+
+    /**
+     * @brief RAII guard of a held mutex, it is returned by co_await scopedLock().
+     */
+    class Guard final {
+    public:
+        explicit Guard(AsyncSafeMutex& mutex, LockStory& lockStory): m_mutex(mutex), m_lockStory(lockStory) {}
+        ~Guard() { m_mutex.unlock(m_lockStory); }
+
+        Guard(const Guard& ) = delete;
+        Guard& operator=(const Guard& ) = delete;
+
+    private:
+        AsyncSafeMutex& m_mutex;
+        LockStory& m_lockStory;
+    };
+
+    class ScopedLockAwaiter final : public LockAwaiter {
+    public:
+        using LockAwaiter::LockAwaiter;
+
+        Guard await_resume() {
+            LockAwaiter::await_resume();
+            return Guard{ m_mutex, m_lockStory };
+        }
+    };
+
+    explicit AsyncSafeMutex();
+    ~AsyncSafeMutex();
+
+    AsyncSafeMutex(const AsyncSafeMutex& ) = delete;
+    AsyncSafeMutex& operator=(const AsyncSafeMutex& ) = delete;
+
+    inline std::uint32_t id() const { return m_id; }
+
+    [[nodiscard]] inline LockAwaiter lock(LockStory& lockStory) { return LockAwaiter{ *this, lockStory }; }
+    [[nodiscard]] inline ScopedLockAwaiter scopedLock(LockStory& lockStory) { return ScopedLockAwaiter{ *this, lockStory }; }
+
+    /**
+     * @brief Acquires the mutex only if it is free, without suspending.
+     */
+    LockResultType tryLock(LockStory& lockStory);
+
+    /**
+     * @brief Releases the mutex and resumes the first waiter (if any) on the calling thread.
+     * @details Called from a coroutine resumed by an unlock() on the same thread, it only queues the waiter for
+     * that unlock() to resume.
+     */
+    void unlock(LockStory& lockStory);
+
+private:
+    // The state is the LockAwaiter* at the head of the newly queued waiters or one of these (never aligned) values
+    static constexpr std::uintptr_t LOCKED_STATE = 0;
+    static constexpr std::uintptr_t UNLOCKED_STATE = 1;
+
+    bool tryAcquire();
+
+    // Returns false if the mutex was released in the meantime and is acquired instead of queueing the awaiter
+    bool enqueue(LockAwaiter& awaiter);
+
+    void onLocking(LockStory& lockStory);
+
+    // Resumes the waiter which has been handed the mutex, or queues it if a resumption already runs on this thread
+    static void resume(LockAwaiter& awaiter);
+
+    std::uint32_t m_id;
+    std::atomic<std::uintptr_t> m_state;
+    LockAwaiter* m_waiters; // FIFO of the waiters taken from m_state, accessed by the holder only
+    LockStory* m_owner;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_ASYNC_SAFE_MUTEX_H
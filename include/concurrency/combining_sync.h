@@ -0,0 +1,180 @@
+#ifndef CONCURRENCY_COMBINING_SYNC_H
+#define CONCURRENCY_COMBINING_SYNC_H
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "include/concurrency/sync.h"
+#include "include/utils/cache_line.h"
+#include "include/utils/cpu_relax.h"
+
+namespace atom::concurrency {
+
+/**
+ * @brief Flat combining: MutableSync for hot objects, where one caller applies the pending updates of all the others.
+ * @details A caller publishes its operation and waits, whichever caller wins the combiner role applies all published
+ * operations in one pass, so the value (and the combiner's cache) stays on one core instead of bouncing between the
+ * cores on every update. The waiters spin on their own publication record and get the result (or the exception) of
+ * their functor back. A thread has at most one pending operation, so the record lives on the caller's stack for the
+ * time of the call instead of in a registered per-thread slot, and publishing it is a push onto a lock-free stack.
+ * The combiner takes the whole stack at once and applies the operations in the order of publication. A caller which
+ * finds no combiner running takes the role right away and applies its own operation without publishing it.
+ * Every access goes through the combiner, so the functors run one at a time but on an arbitrary thread: they must
+ * not depend on thread-local state, and must not access the same CombiningSync (that would wait for itself).
+ * @example
+ *      CombiningSync<std::unordered_map<Key, Value>> map;
+ *
+ *      const auto inserted = map.accessMutable([&](auto& map) { return map.emplace(key, value).second; });
+ */
+template<typename T>
+class CombiningSync final {
+public:
+    using ValueType = T;
+    using MutableValueRefType = ValueType&;
+    using ImmutableValueRefType = const ValueType&;
+
+    // The combiner takes the newly published operations at most this many times before it hands the role over
+    static constexpr std::uint32_t MAX_COMBINE_PASSES = 4;
+    // A waiter spins this many times before it starts to yield its core to the combiner
+    static constexpr std::uint32_t SPIN_LIMIT = 256;
+
+    template<typename ... Args>
+    CombiningSync(Args&& ... args):
+    m_pending(nullptr),
+    m_combining(false),
+    m_value(std::forward<Args>(args) ...) {}
+
+    CombiningSync(const CombiningSync& ) = delete;
+    CombiningSync& operator=(const CombiningSync& ) = delete;
+
+    /**
+     * @brief Applies f to the value on the combiner thread and returns its result.
+     */
+    template<typename Func>
+    std::invoke_result_t<Func&, T&> accessMutable(Func f) {
+        return execute<T&>(f);
+    }
+
+    template<typename Func>
+    std::invoke_result_t<Func&, const T&> accessImmutable(Func f) const {
+        static_assert(__details::IsCallableWithConstRef<T, Func>::value, "Func must accept const T&");
+        return execute<const T&>(f);
+    }
+
+    inline void setValue(const T& newValue) { accessMutable([&newValue](T& value) { value = newValue; }); }
+    inline void setValue(T&& newValue) { accessMutable([&newValue](T& value) { value = std::move(newValue); }); }
+
+    inline T getValue() const { return accessImmutable([](const T& value) { return value; }); }
+
+private:
+    // A published operation, it is owned by the waiting caller
+    struct alignas(utils::CACHE_LINE_SIZE) Request final {
+        void (*invoke)(void* operation, T& value) = nullptr;
+        void* operation = nullptr;
+        std::exception_ptr exception;
+        Request* next = nullptr;
+        std::atomic<bool> done = false;
+    };
+
+    template<typename Ref, typename Func>
+    std::invoke_result_t<Func&, Ref> execute(Func& f) const {
+        using ResultType = std::invoke_result_t<Func&, Ref>;
+        static_assert(!std::is_reference_v<ResultType>, "A reference to the value must not escape the combiner");
+
+        if constexpr (std::is_void_v<ResultType>) {
+            auto operation = [&f](T& value) { f(static_cast<Ref>(value)); };
+            publishAndWait(operation);
+        } else {
+            std::optional<ResultType> result;
+            auto operation = [&f, &result](T& value) { result.emplace(f(static_cast<Ref>(value))); };
+            publishAndWait(operation);
+            return std::move(*result);
+        }
+    }
+
+    template<typename Operation>
+    void publishAndWait(Operation& operation) const {
+        // Without a combiner the caller becomes one right away and applies its operation without publishing it
+        if (!m_combining.load(std::memory_order_relaxed) && !m_combining.exchange(true, std::memory_order_acquire)) {
+            std::exception_ptr exception;
+            try {
+                operation(m_value);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+            combine();
+            m_combining.store(false, std::memory_order_release);
+
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+            return;
+        }
+
+        Request request;
+        request.operation = &operation;
+        request.invoke = [](void* operation, T& value) { (*static_cast<Operation*>(operation))(value); };
+
+        request.next = m_pending.load(std::memory_order_relaxed);
+        while (!m_pending.compare_exchange_weak(request.next, &request, std::memory_order_release, std::memory_order_relaxed)) {}
+
+        for (std::uint32_t spins = 0; !request.done.load(std::memory_order_acquire); ++spins) {
+            if (!m_combining.load(std::memory_order_relaxed) && !m_combining.exchange(true, std::memory_order_acquire)) {
+                combine();
+                m_combining.store(false, std::memory_order_release);
+            } else if (spins < SPIN_LIMIT) {
+                utils::CpuRelax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        if (request.exception) {
+            std::rethrow_exception(request.exception);
+        }
+    }
+
+    void combine() const {
+        for (std::uint32_t pass = 0; pass < MAX_COMBINE_PASSES; ++pass) {
+            auto* stack = m_pending.exchange(nullptr, std::memory_order_acquire);
+            if (!stack) {
+                return;
+            }
+
+            // The stack is in the reverse order of publication
+            Request* queue = nullptr;
+            while (stack) {
+                auto* next = stack->next;
+                stack->next = queue;
+                queue = stack;
+                stack = next;
+            }
+
+            while (queue) {
+                // The waiter may return (and destroy the request) as soon as it is done
+                auto* next = queue->next;
+                try {
+                    queue->invoke(queue->operation, m_value);
+                } catch (...) {
+                    queue->exception = std::current_exception();
+                }
+                queue->done.store(true, std::memory_order_release);
+                queue = next;
+            }
+        }
+    }
+
+    // A const access is an operation as well, it goes through the same combiner which may apply mutable ones
+    alignas(utils::CACHE_LINE_SIZE) mutable std::atomic<Request*> m_pending;
+    alignas(utils::CACHE_LINE_SIZE) mutable std::atomic<bool> m_combining;
+    mutable T m_value;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_COMBINING_SYNC_H
@@ -0,0 +1,133 @@
+#ifndef CONCURRENCY_EPOCH_DOMAIN_H
+#define CONCURRENCY_EPOCH_DOMAIN_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "include/utils/cache_line.h"
+
+namespace atom::concurrency {
+
+namespace __details {
+
+/**
+ * @brief Announcement of a thread in an EpochDomain, it takes a cache line so that entering an epoch writes to
+ * a line no other thread writes.
+ */
+struct alignas(utils::CACHE_LINE_SIZE) EpochRecord final {
+    static constexpr std::uint64_t QUIESCENT = 0;
+
+    std::atomic<std::uint64_t> epoch = QUIESCENT; // The epoch the thread has entered
+    std::atomic<bool> inUse = false;              // The record is taken by a live thread
+    std::uint32_t nesting = 0;                    // Accessed by the owner thread only
+    EpochRecord* next = nullptr;                  // Immutable once the record is published
+};
+
+} //! namespace __details
+
+/**
+ * @brief Epoch-based reclamation: the memory unlinked from a shared structure is freed once no reader can see it.
+ * @details A reader enters the domain with a Guard: it announces the current global epoch in its own thread record
+ * (a store and a check, no RMW on shared memory and no allocation), and leaves it with a store on exit. A writer
+ * unlinks an object and retire()s it, the object is stamped with the global epoch. The epoch advances only once
+ * every thread inside the domain has announced the current epoch, so when it has advanced twice past the stamp of
+ * an object no reader can still hold the object and it is deleted.
+ * Retired objects are reclaimed every RECLAIM_THRESHOLD retirements or on an explicit reclaim()/synchronize().
+ * A thread which stays inside the domain for long holds back the reclamation (but never the readers or the writers).
+ * Guards nest, the thread leaves the domain with the outermost one.
+ * @warning synchronize() must not be called inside a Guard of the same domain, it would wait for itself.
+ * @example
+ *      std::atomic<const Table*> table;
+ *
+ *      void lookup(Key key) {
+ *          EpochDomain::Guard guard;
+ *          table.load()->find(key);
+ *      }
+ *
+ *      void update(const Table* newTable) {
+ *          EpochDomain::instance().retire(table.exchange(newTable));
+ *      }
+ */
+class EpochDomain final {
+public:
+    using EpochType = std::uint64_t;
+    using DeleterType = void (*)(void* object);
+
+    static constexpr std::size_t RECLAIM_THRESHOLD = 64;
+
+    /**
+     * @brief RAII read-side critical section.
+     */
+    class Guard final {
+    public:
+        explicit Guard(EpochDomain& domain = EpochDomain::instance());
+        ~Guard();
+
+        Guard(const Guard& ) = delete;
+        Guard& operator=(const Guard& ) = delete;
+
+    private:
+        __details::EpochRecord& m_record;
+    };
+
+    /**
+     * @brief The process-wide domain used by default.
+     */
+    static EpochDomain& instance();
+
+    explicit EpochDomain();
+
+    /**
+     * @brief Deletes all retired objects, nobody may be inside the domain any more.
+     */
+    ~EpochDomain();
+
+    EpochDomain(const EpochDomain& ) = delete;
+    EpochDomain& operator=(const EpochDomain& ) = delete;
+
+    void retire(void* object, DeleterType deleter);
+
+    template<typename T>
+    inline void retire(const T* object) {
+        retire(const_cast<T*>(object), [](void* object) { delete static_cast<T*>(object); });
+    }
+
+    /**
+     * @brief Advances the epoch if every reader has caught up with it and deletes the objects no reader can see.
+     * @return The number of deleted objects.
+     */
+    std::size_t reclaim();
+
+    /**
+     * @brief Waits until all objects retired before the call are deleted.
+     */
+    void synchronize();
+
+    inline EpochType epoch() const { return m_epoch.load(); }
+    std::size_t retiredCount() const;
+
+private:
+    struct Retired final {
+        EpochType epoch;
+        void* object;
+        DeleterType deleter;
+    };
+
+    // The record of the calling thread, it is taken on the first use and given back when the thread exits
+    __details::EpochRecord& threadRecord();
+    void enter(__details::EpochRecord& record) const;
+    bool tryAdvance();
+
+    std::uint64_t m_id;
+    std::atomic<EpochType> m_epoch;
+    std::atomic<__details::EpochRecord*> m_records;
+    mutable std::mutex m_retiredMutex;
+    std::vector<Retired> m_retired;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_EPOCH_DOMAIN_H
@@ -0,0 +1,100 @@
+#ifndef CONCURRENCY_LOCK_ORDER_GRAPH_H
+#define CONCURRENCY_LOCK_ORDER_GRAPH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <shared_mutex>
+
+namespace atom::concurrency {
+
+/**
+ * @brief Process-wide lock-order graph (lockdep-style).
+ * @details Every time a thread acquires a lock while holding another one, the (held -> acquiring) edges are
+ * recorded here. An edge is stored only once: repeated acquisitions in an already known order cost a lookup
+ * under a shared lock, and the cycle check runs only when a genuinely new edge appears.
+ * A cycle in this graph means that two (or more) code paths take the same locks in a different order, that is
+ * a potential deadlock, even if the threads have never actually collided yet.
+ *
+ * The nodes are the lock ids, which are dense and reused, so the nodes are kept in a vector indexed by the id up to
+ * the highest id with an edge. A node enters the graph lazily with its first edge, so the locks which are never
+ * ordered (all of them while the checks and the sampler are off) cost the graph nothing. A node keeps its
+ * successors and predecessors in sorted vectors, so the memory grows with the number of edges rather than with the
+ * square of the number of locks. A new edge closes a cycle of any length iff the target already reaches the
+ * source, which is checked with a search from the target over the part of the graph reachable from it: the visited
+ * and the source sets of the search are id-indexed bit sets reused from one search to the next. Removing a node
+ * unlinks it from its neighbours only.
+ * @warning Every lock must remove its node with removeNode() on destruction, the id is then reused by a new lock.
+ */
+class LockOrderGraph final {
+public:
+    using NodeType = std::uint32_t;
+
+    static LockOrderGraph& instance();
+
+    explicit LockOrderGraph();
+
+    LockOrderGraph(const LockOrderGraph& ) = delete;
+    LockOrderGraph& operator=(const LockOrderGraph& ) = delete;
+
+    /**
+     * @brief Drops the node with all its edges, a node without edges is not in the graph and costs a load.
+     */
+    void removeNode(NodeType node);
+
+    /**
+     * @brief Records the edge from -> to.
+     * @return false if the edge closes a cycle (the edge is not recorded in this case), true otherwise.
+     */
+    bool addEdge(NodeType from, NodeType to);
+
+    /**
+     * @brief Records the edges from every node of the set to the node `to` at once.
+     * @return false if any of the edges closes a cycle (nothing is recorded in this case), true otherwise.
+     */
+    bool addEdges(std::span<const NodeType> from, NodeType to);
+    bool hasEdge(NodeType from, NodeType to) const;
+
+    /**
+     * @brief Number of the nodes with at least one edge.
+     */
+    inline std::size_t size() const { return m_size.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Drops all nodes and edges.
+     */
+    void clear();
+
+private:
+    using WordType = std::uint64_t;
+
+    struct Node final {
+        std::vector<NodeType> successors;
+        std::vector<NodeType> predecessors;
+
+        inline bool isolated() const { return successors.empty() && predecessors.empty(); }
+    };
+
+    inline bool hasNode(const NodeType node) const { return node < m_nodes.size() && !m_nodes[node].isolated(); }
+
+    // Makes the node vector and the bit sets cover the id
+    void reserve(NodeType node);
+    bool hasEdgesImpl(std::span<const NodeType> from, NodeType to) const;
+    bool reachesAny(NodeType from, std::span<const NodeType> targets);
+    void link(NodeType node, NodeType neighbour, std::vector<NodeType> Node::* edges);
+    void unlink(NodeType node, NodeType neighbour, std::vector<NodeType> Node::* edges);
+
+    std::vector<Node> m_nodes;
+    // The scratch of reachesAny(), it is used under the exclusive lock and the bit sets are all clear in between
+    std::vector<WordType> m_visited;
+    std::vector<WordType> m_targets;
+    std::vector<NodeType> m_reached;
+    std::atomic<std::size_t> m_size; // The number of the nodes with edges, read without the lock
+    mutable std::shared_mutex m_mutex;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_LOCK_ORDER_GRAPH_H
@@ -0,0 +1,111 @@
+#ifndef CONCURRENCY_LOCK_PROFILER_H
+#define CONCURRENCY_LOCK_PROFILER_H
+
+#include "include/utils/cache_line.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+#include <cstdint>
+
+namespace atom::concurrency {
+
+struct LockProfileSnapshot final {
+    using HistogramType = std::array<std::uint64_t, 32>;
+
+    std::string name;
+    std::uint64_t acquisitions;
+    std::uint64_t contended;
+    std::chrono::nanoseconds totalWait;
+    std::chrono::nanoseconds totalHold;
+    HistogramType waitHistogram;
+    HistogramType holdHistogram;
+};
+
+/**
+ * @brief Contention statistics of one lock: acquisition and contended counts, wait and hold time histograms.
+ * @details Histograms are log2-bucketed by nanoseconds: the bucket i counts durations in [2^(i-1), 2^i) ns.
+ * The counters are split into cache line padded shards and every thread updates only its own shard with relaxed
+ * atomics, so recording never bounces a line between cores and never takes a lock. Shards are summed on snapshot().
+ * onAcquire()/onRelease() must be called by the lock owner only, the acquisition time is kept in a plain field.
+ */
+class LockProfile final {
+public:
+    using ClockType = std::chrono::steady_clock;
+    using HistogramType = LockProfileSnapshot::HistogramType;
+
+    static constexpr std::size_t SHARDS = 8;
+    static constexpr std::size_t BUCKETS = std::tuple_size_v<HistogramType>;
+
+    explicit LockProfile(std::string_view name);
+    ~LockProfile();
+
+    LockProfile(const LockProfile& ) = delete;
+    LockProfile& operator=(const LockProfile& ) = delete;
+
+    void onAcquire(bool contended, ClockType::duration waitTime);
+    void onRelease();
+
+    LockProfileSnapshot snapshot() const;
+    void reset();
+
+    static std::size_t BucketOf(ClockType::duration duration);
+    static std::string NameOf(std::string_view name);
+    static std::string NameOf(const std::source_location& location);
+
+private:
+    struct alignas(utils::CACHE_LINE_SIZE) Shard final {
+        std::atomic<std::uint64_t> acquisitions{ 0 };
+        std::atomic<std::uint64_t> contended{ 0 };
+        std::atomic<std::uint64_t> totalWaitNs{ 0 };
+        std::atomic<std::uint64_t> totalHoldNs{ 0 };
+        std::array<std::atomic<std::uint64_t>, BUCKETS> waitHistogram{};
+        std::array<std::atomic<std::uint64_t>, BUCKETS> holdHistogram{};
+    };
+
+    static std::size_t CurrentShard();
+
+    std::string m_name;
+    ClockType::time_point m_acquiredAt;
+    std::array<Shard, SHARDS> m_shards;
+};
+
+/**
+ * @brief Registry of all live LockProfile instances.
+ * @details Lock profiling is opt-in: build with -DENABLE_LOCK_PROFILING=ON (defines ATOM_LOCK_PROFILING) to make every
+ * SafeMutex own a LockProfile. Without it SafeMutex carries no profiling state and no extra instructions.
+ */
+class LockProfiler final {
+public:
+    static LockProfiler& instance();
+
+    explicit LockProfiler();
+
+    LockProfiler(const LockProfiler& ) = delete;
+    LockProfiler& operator=(const LockProfiler& ) = delete;
+
+    void add(LockProfile& profile);
+    void remove(LockProfile& profile);
+
+    /**
+     * @brief Returns snapshots of all live profiles sorted by the total wait time, the worst bottleneck first.
+     */
+    std::vector<LockProfileSnapshot> snapshot() const;
+    void report(std::ostream& os) const;
+    void reset();
+
+private:
+    std::unordered_set<LockProfile*> m_profiles;
+    mutable std::mutex m_mutex;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_LOCK_PROFILER_H
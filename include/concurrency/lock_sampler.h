@@ -0,0 +1,116 @@
+#ifndef CONCURRENCY_LOCK_SAMPLER_H
+#define CONCURRENCY_LOCK_SAMPLER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+
+namespace atom::concurrency {
+
+/**
+ * @brief Sampled lock order checking for release builds, where SafeMutex doesn't keep a LockStory.
+ * @details Every thread tracks the ids of the locks it holds in a small thread-local set (a push and a pop, no
+ * graph work) and only every N-th acquisition of the thread records the (held -> acquiring) edges in the global
+ * LockOrderGraph. Across many processes and long runs the sampled edges converge to the full lock order graph,
+ * so a lock order inversion is eventually reported without paying for the check on every acquisition.
+ * A violation doesn't abort the process: the edge is rejected and the report handler is called.
+ *
+ * The interval is taken from the ATOM_LOCK_SAMPLING environment variable at start-up and can be changed at any
+ * time with setInterval(). The distance between two samples of a thread is randomized around the interval, so a
+ * periodic locking pattern can't hide from the sampler. 0 disables the sampler, then an acquisition costs one
+ * relaxed load and a branch. Locks acquired while the sampler was off are not in the held set, so the edges from
+ * them are missed.
+ * @example ATOM_LOCK_SAMPLING=1000 ./service   # check 1 in 1000 acquisitions of every thread
+ */
+class LockSampler final {
+public:
+    using ReportHandlerType = void (*)(std::span<const std::uint32_t> held, std::uint32_t acquiring);
+
+    /**
+     * @brief Maximum number of tracked held locks per thread, the deeper locks are not tracked.
+     */
+    static constexpr std::size_t MAX_HELD_LOCKS = 16;
+
+    static void setInterval(std::uint32_t interval);
+    static std::uint32_t interval();
+
+    /**
+     * @brief Replaces the handler called on every detected violation (the default one prints to std::cerr),
+     * nullptr restores the default handler.
+     */
+    static void setReportHandler(ReportHandlerType handler);
+    static std::uint64_t violations();
+
+    /**
+     * @brief Called before a blocking acquisition: samples the lock order and puts the lock into the held set.
+     * @details The held set is updated before the acquisition, so a failed timed acquisition must take the lock
+     * back with onReleased().
+     */
+    static inline void onAcquiring(const std::uint32_t id) {
+        const auto interval = s_interval.load(std::memory_order_acquire);
+        if (interval != 0) {
+            auto& thread = Current();
+            // A countdown drawn for a longer interval is cut short, so a new interval applies right away
+            if (thread.countdown > 1 && thread.countdown / 2 < interval) {
+                --thread.countdown;
+            } else {
+                Sample(thread, id);
+            }
+            Push(thread, id);
+        }
+    }
+
+    /**
+     * @brief Called after a successful try-acquisition, it is not sampled because a failed try can't deadlock.
+     */
+    static inline void onAcquired(const std::uint32_t id) {
+        if (s_interval.load(std::memory_order_acquire) != 0) {
+            Push(Current(), id);
+        }
+    }
+
+    static inline void onReleased(const std::uint32_t id) {
+        // The held sets stay empty until the sampler is switched on for the first time, so a release skips them
+        if (!s_everEnabled.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        auto& thread = Current();
+        for (auto i = thread.size; i > 0; --i) {
+            if (thread.held[i - 1] == id) {
+                thread.held[i - 1] = thread.held[--thread.size];
+                return;
+            }
+        }
+    }
+
+private:
+    struct ThreadState final {
+        std::array<std::uint32_t, MAX_HELD_LOCKS> held{};
+        std::size_t size = 0;
+        std::uint32_t countdown = 0;
+        std::uint32_t random = 0;
+    };
+
+    static inline ThreadState& Current() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    static inline void Push(ThreadState& thread, const std::uint32_t id) {
+        if (thread.size < MAX_HELD_LOCKS) {
+            thread.held[thread.size++] = id;
+        }
+    }
+
+    static void Sample(ThreadState& thread, std::uint32_t id);
+
+    static std::atomic<std::uint32_t> s_interval;
+    // Set before the first non-zero interval is published and never reset
+    static std::atomic<bool> s_everEnabled;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_LOCK_SAMPLER_H
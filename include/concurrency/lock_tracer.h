@@ -0,0 +1,146 @@
+#ifndef CONCURRENCY_LOCK_TRACER_H
+#define CONCURRENCY_LOCK_TRACER_H
+
+#include "include/utils/cache_line.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+
+namespace atom::concurrency {
+
+enum class LockEventType : std::uint8_t {
+    Acquire, // The lock is taken, waitTime is the time spent blocked (0 for an uncontended acquire)
+    Release, // The lock is released
+    Destroy  // The lock is destroyed, its id may be reused by a new lock after this event
+};
+
+/**
+ * @brief One record of the binary trace, the file is the LockTraceHeader followed by an array of them.
+ */
+struct LockEvent final {
+    std::uint64_t timestamp; // std::chrono::steady_clock nanoseconds
+    std::uint32_t threadId;  // Dense id of the recording thread in the order of its first event
+    std::uint32_t mutexId;   // SafeMutex::id()
+    std::uint32_t waitTime;  // Nanoseconds, saturated at ~4.3 s
+    LockEventType type;
+};
+
+static_assert(sizeof(LockEvent) == 24);
+
+struct LockTraceHeader final {
+    static constexpr std::array<char, 8> MAGIC = { 'A', 'T', 'O', 'M', 'L', 'K', 'T', 'R' };
+    static constexpr std::uint32_t VERSION = 1;
+
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t eventSize;
+    std::uint64_t capacity;  // Number of event slots in the file
+    std::uint64_t size;      // Number of reserved events, the ones beyond the capacity are dropped
+};
+
+static_assert(sizeof(LockTraceHeader) % alignof(LockEvent) == 0);
+
+namespace __details {
+
+/**
+ * @brief Single-producer ring of one thread, the owner appends at the tail, drains move the head.
+ */
+struct alignas(utils::CACHE_LINE_SIZE) TraceRing final {
+    static constexpr std::size_t SIZE = 1024;
+
+    std::array<LockEvent, SIZE> events;
+    std::atomic<std::uint64_t> tail = 0;
+    alignas(utils::CACHE_LINE_SIZE) std::atomic<std::uint64_t> head = 0;
+    std::mutex drainMutex;
+    std::uint32_t threadId = 0;
+};
+
+} //! namespace __details
+
+/**
+ * @brief Records the binary trace of lock events of the whole process into a memory-mapped file.
+ * @details Every thread writes its events into its own single-producer ring buffer: the inline record() is a clock
+ * read and a few stores, without any lock or shared cache line. A full ring is drained by its own thread, it
+ * reserves a range of event slots in the file with one atomic add on the mapped header and copies the ring there.
+ * stop() drains the rings of all threads, a thread which exits drains its ring as well.
+ * The file is written in place, so even the trace of a crashed process keeps all drained events. Events of
+ * different threads are not ordered in the file, the reader sorts them by the timestamp.
+ *
+ * SafeMutex records its events in builds with ATOM_LOCK_TRACING (CMake option ENABLE_LOCK_TRACING) and only
+ * while the tracer is started. The atom-lockanalyze tool rebuilds the lock order graph from a trace and reports
+ * the lock order cycles, the longest convoys and the most contended time windows.
+ * @example LockTracer::start("/tmp/service.locktrace");
+ *          runWorkload();
+ *          LockTracer::stop();
+ *          // $ atom-lockanalyze /tmp/service.locktrace
+ */
+class LockTracer final {
+public:
+    using ClockType = std::chrono::steady_clock;
+
+    static constexpr std::size_t DEFAULT_CAPACITY = std::size_t{ 1 } << 22;
+
+    /**
+     * @brief Creates (truncates) the trace file with room for `capacity` events and starts recording.
+     * @return false if the tracer is already started or the file can't be created and mapped.
+     */
+    static bool start(const std::string& path, std::size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Stops recording, drains all rings and truncates the file to the recorded events.
+     * @details Events which race with stop() can be lost.
+     */
+    static void stop();
+
+    static inline bool isActive() { return s_active.load(std::memory_order_relaxed); }
+
+    static inline void record(const LockEventType type, const std::uint32_t mutexId, const ClockType::duration waitTime) {
+        if (!isActive()) {
+            return;
+        }
+
+        auto* ring = CurrentRing();
+        if (!ring) {
+            ring = RegisterThread();
+        }
+
+        const auto tail = ring->tail.load(std::memory_order_relaxed);
+        if (tail - ring->head.load(std::memory_order_acquire) == __details::TraceRing::SIZE) {
+            Drain(*ring);
+        }
+
+        const auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(waitTime).count();
+        ring->events[tail % __details::TraceRing::SIZE] = LockEvent{
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                ClockType::now().time_since_epoch()).count()),
+            ring->threadId,
+            mutexId,
+            static_cast<std::uint32_t>(std::min<std::int64_t>(wait, std::numeric_limits<std::uint32_t>::max())),
+            type
+        };
+        ring->tail.store(tail + 1, std::memory_order_release);
+    }
+
+private:
+    using RingType = __details::TraceRing;
+
+    static inline RingType*& CurrentRing() {
+        thread_local RingType* ring = nullptr;
+        return ring;
+    }
+
+    static RingType* RegisterThread();
+    static void Drain(RingType& ring);
+
+    static std::atomic<bool> s_active;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_LOCK_TRACER_H
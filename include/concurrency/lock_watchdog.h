@@ -0,0 +1,112 @@
+#ifndef CONCURRENCY_LOCK_WATCHDOG_H
+#define CONCURRENCY_LOCK_WATCHDOG_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+
+namespace atom::concurrency {
+
+class LockStory;
+
+enum class WatchdogAction : std::uint8_t {
+    Report, // Call the report handler and keep running
+    Abort   // Call the report handler and abort the process
+};
+
+namespace __details {
+
+/**
+ * @brief Entry of the global wait-for table, it lives on the stack of the waiting thread.
+ */
+struct WaitRecord final {
+    static constexpr std::size_t MAX_HELD_LOCKS = 16;
+    static constexpr std::uint32_t NO_LOCK = UINT32_MAX;
+
+    const LockStory* story = nullptr;
+    std::thread::id threadId;
+    std::uint32_t lockId = NO_LOCK;  // The awaited lock, NO_LOCK for an external wait
+    std::string_view what;           // Description of an external wait
+    std::chrono::steady_clock::time_point since;
+    std::array<std::uint32_t, MAX_HELD_LOCKS> held{};
+    std::size_t heldCount = 0;
+    bool reported = false;           // Accessed by the watchdog only
+    WaitRecord* prev = nullptr;
+    WaitRecord* next = nullptr;
+};
+
+} //! namespace __details
+
+/**
+ * @brief Optional background thread which detects stuck waiters and reports the wait-for graph.
+ * @details While the watchdog runs, every blocking wait registers in a global wait-for table together with the
+ * locks its LockStory holds: a parked SafeMutex waiter (only after the spinning phase, the lock path itself never
+ * touches the table), a SafeConditionVariable waiter, and any wait outside of the library wrapped in a WaitGuard
+ * (IO, futures, foreign locks). The watchdog wakes up every half of the threshold and, once some wait is longer
+ * than the threshold, links every waiter to the waiters holding the lock it waits for. The report lists all waits
+ * with their held locks and every cycle of the graph, that is a deadlock. The watchdog doesn't know who ends an
+ * external wait, so a cycle never goes through one: an external wait ends the chains of the waiters blocked on
+ * the locks its thread holds, and the report shows it with those locks.
+ * Each wait is reported once. SafeMutex registers its waits in checked builds only, the release SafeMutex doesn't
+ * keep the held locks (nor does the LockStory while the RuntimeChecks are off).
+ * @example LockWatchdog::start(std::chrono::seconds(5), WatchdogAction::Abort);
+ *
+ *          void readConfig(LockStory& lockStory) {
+ *              LockWatchdog::WaitGuard wait{ lockStory, "config socket read" };
+ *              socket.read(buffer);
+ *          }
+ */
+class LockWatchdog final {
+public:
+    using ClockType = std::chrono::steady_clock;
+    using ReportHandlerType = void (*)(std::string_view report);
+
+    /**
+     * @brief Registers the calling thread in the wait-for table for its lifetime, if the watchdog is running.
+     */
+    class WaitGuard final {
+    public:
+        // An external wait, the description must outlive the guard
+        explicit WaitGuard(const LockStory& lockStory, std::string_view what);
+        // A wait for a lock with the given id
+        explicit WaitGuard(const LockStory& lockStory, std::uint32_t lockId);
+        ~WaitGuard();
+
+        WaitGuard(const WaitGuard& ) = delete;
+        WaitGuard& operator=(const WaitGuard& ) = delete;
+
+    private:
+        __details::WaitRecord m_record;
+        bool m_registered;
+    };
+
+    /**
+     * @brief Starts the watchdog thread.
+     * @return false if it is already running.
+     */
+    static bool start(ClockType::duration threshold, WatchdogAction action = WatchdogAction::Report);
+    static void stop();
+
+    static inline bool isActive() { return s_active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Replaces the handler called with every report (the default one prints to std::cerr),
+     * nullptr restores the default handler.
+     */
+    static void setReportHandler(ReportHandlerType handler);
+    static std::uint64_t reports();
+
+private:
+    static void Register(__details::WaitRecord& record, const LockStory& lockStory);
+    static void Unregister(__details::WaitRecord& record);
+    static void Scan();
+
+    static std::atomic<bool> s_active;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_LOCK_WATCHDOG_H
@@ -9,7 +9,7 @@
 
 namespace atom::concurrency {
 
-#ifdef NDEBUG
+#ifndef ATOM_CHECKED_BUILD
 
 template<typename T, typename C>
 class BasicRef;
@@ -180,7 +180,9 @@ m_value(std::forward<Args>(args) ...)
 
 template<typename T, typename C>
 BasicOwner<T, C>::~BasicOwner() {
-    PANIC(m_refCount.getValue() > 0);
+    if (RuntimeChecks::enabled()) {
+        PANIC(m_refCount.getValue() > 0);
+    }
 }
 
 template<typename T, typename C>
@@ -204,12 +206,19 @@ BasicRef<T, C> BasicOwner<T, C>::getMutableRef()
 template<typename T, typename C>
 void BasicOwner<T, C>::decrementRefCount()
 {
+    // Without the checks nobody reads the counter, so it is not maintained at all
+    if (!RuntimeChecks::enabled()) [[likely]] {
+        return;
+    }
     m_refCount.accessMutable([](RefCountType& refCount) { --refCount; });
 }
 
 template<typename T, typename C>
 void BasicOwner<T, C>::incrementRefCount()
 {
+    if (!RuntimeChecks::enabled()) [[likely]] {
+        return;
+    }
     m_refCount.accessMutable([](RefCountType& refCount) { ++refCount; });
 }
 
@@ -275,7 +284,7 @@ void BasicRef<T, C>::accessMutable(Func f)
     });
 }
 
-#endif //! NDEBUG
+#endif //! ifndef ATOM_CHECKED_BUILD
 
 } //! namespace atom::concurrency
 
@@ -0,0 +1,130 @@
+#ifndef CONCURRENCY_QUEUE_LOCK_H
+#define CONCURRENCY_QUEUE_LOCK_H
+
+#include "include/concurrency/safe_mutex.h"
+#include "include/utils/cache_line.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace atom::concurrency {
+
+namespace __details {
+
+/**
+ * @brief Queue entry of a waiter, each node fills its own cache line, so a waiter spins on a line nobody else reads.
+ * @details The nodes come from a thread-local cache: a lock()/unlock() pair doesn't allocate once the cache of the
+ * thread has warmed up.
+ */
+struct alignas(utils::CACHE_LINE_SIZE) QueueNode final {
+    std::atomic<QueueNode*> next = nullptr; // McsLock only
+    std::atomic<bool> locked = false;
+};
+
+/**
+ * @brief The LockStory (checked builds) and LockSampler (release builds) bookkeeping shared by the queue locks.
+ */
+class QueueLockChecks final {
+public:
+    static void onLock(LockStory& lockStory, std::uint32_t id);
+    static bool onTryLock(LockStory& lockStory, std::uint32_t id);
+    static void onLocked(LockStory& lockStory, std::uint32_t id);
+    static void onUnlock(LockStory& lockStory, std::uint32_t id);
+};
+
+} //! namespace __details
+
+/**
+ * @brief MCS queue lock for very short critical sections under many cores.
+ * @details The lock is a single tail pointer. A waiter appends its own node to the queue and spins on it, so the
+ * release writes to the cache line of exactly one waiter instead of the whole crowd hammering one shared word (or
+ * the inner mutex and condition variable of a parked SafeMutex). The lock is handed off in FIFO order.
+ * It has the SafeMutex lock(LockStory&)/unlock(LockStory&) interface and takes part in the same deadlock tooling:
+ * the lock order graph and the LockStory in checked builds, the LockSampler in release builds, and a waiter which
+ * spins for long shows up in the LockWatchdog table.
+ * A waiter spins with a pause for a while and then yields its core between the checks, it never parks, so prefer
+ * SafeMutex for the locks which are held for long or when there are more waiters than cores.
+ * @warning A thread must unlock the queue locks it has locked (the queue node belongs to the locking thread).
+ * The LockProfiler and the LockTracer don't see the queue locks.
+ * @example
+ *      McsLock lock;
+ *
+ *      void increment(LockStory& lockStory) {
+ *          lock.lock(lockStory);
+ *          ++counter;
+ *          lock.unlock(lockStory);
+ *      }
+ */
+class McsLock final {
+public:
+    explicit McsLock();
+    ~McsLock();
+
+    McsLock(const McsLock& ) = delete;
+    McsLock& operator=(const McsLock& ) = delete;
+
+    inline std::uint32_t id() const { return m_id; }
+
+    void lock(LockStory& lockStory);
+    void unlock(LockStory& lockStory);
+
+    /**
+     * @brief Acquires the lock only if it is free and nobody waits for it.
+     */
+    LockResultType tryLock(LockStory& lockStory);
+
+    /**
+     * @brief std::Lockable interface backed by LockStory::current().
+     */
+    void lock();
+    void unlock();
+    bool try_lock();
+
+private:
+    void acquire(const LockStory& lockStory);
+    void release();
+
+    std::uint32_t m_id;
+    std::atomic<__details::QueueNode*> m_tail;
+    __details::QueueNode* m_owner; // The node of the holder, accessed by the holder only
+};
+
+/**
+ * @brief CLH queue lock, the implicit-queue sibling of McsLock.
+ * @details A waiter swaps its node into the tail and spins on the node of its predecessor, the release is a single
+ * store to the holder's own node and doesn't have to wait for the successor to link itself (McsLock does). The
+ * holder then adopts the node of its predecessor, so the nodes travel between the threads and the lock always
+ * keeps one of them as the tail.
+ * The checks, the hand-off order and the waiting are the same as McsLock ones.
+ * @warning There is no tryLock(): the tail node may be recycled and queued again between the check and the swap,
+ * so a try could end up waiting in the queue. ClhLock is std::BasicLockable only.
+ */
+class ClhLock final {
+public:
+    explicit ClhLock();
+    ~ClhLock();
+
+    ClhLock(const ClhLock& ) = delete;
+    ClhLock& operator=(const ClhLock& ) = delete;
+
+    inline std::uint32_t id() const { return m_id; }
+
+    void lock(LockStory& lockStory);
+    void unlock(LockStory& lockStory);
+
+    void lock();
+    void unlock();
+
+private:
+    void acquire(const LockStory& lockStory);
+    void release();
+
+    std::uint32_t m_id;
+    std::atomic<__details::QueueNode*> m_tail;
+    __details::QueueNode* m_owner;       // The node of the holder, the successor spins on it
+    __details::QueueNode* m_ownerPred;   // The node of the predecessor, the holder takes it on release
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_QUEUE_LOCK_H
@@ -0,0 +1,148 @@
+#ifndef CONCURRENCY_RANKED_MUTEX_H
+#define CONCURRENCY_RANKED_MUTEX_H
+
+#include <mutex>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "include/utils/assertion.h"
+
+namespace atom::concurrency {
+
+template<std::size_t Level, typename Mutex = std::mutex>
+class RankedMutex;
+
+template<typename Mutex, std::size_t ... Levels>
+class BasicRankedLock;
+
+template<std::size_t ... Levels>
+using RankedLock = BasicRankedLock<std::mutex, Levels ...>;
+
+template<std::size_t Level, typename Mutex>
+BasicRankedLock<Mutex, Level> LockRanked(RankedMutex<Level, Mutex>& mutex);
+
+namespace __details {
+
+template<std::size_t ... Levels>
+inline constexpr std::size_t MaxRank = std::max({ std::size_t{ 0 }, Levels ... });
+
+template<std::size_t ... Levels>
+inline constexpr bool HoldsAnyRank = sizeof...(Levels) > 0;
+
+// Next is lockable if nothing is held yet or it is strictly greater than every held rank
+template<std::size_t Next, std::size_t ... Levels>
+inline constexpr bool CanLockRank = !HoldsAnyRank<Levels ...> || Next > MaxRank<Levels ...>;
+
+} //! namespace __details
+
+/**
+ * @brief Mutex with a compile-time rank (lock hierarchy level).
+ * @details RankedMutex is the compile-time counterpart of the SafeMutex/LockStory lock order check: instead of
+ * recording the order at runtime the held ranks are carried in the type of the RankedLock guard, and locking a
+ * mutex whose rank is lower than or equal to any held rank doesn't compile. Taking locks only in strictly increasing
+ * rank order can't deadlock, so no runtime check is needed and the cost is exactly the cost of std::mutex
+ * in every build type. The underlying Mutex is std::mutex unless a test needs to observe the lock and unlock
+ * calls.
+ * A guard is consumed by the lock() of the next rank, so a chain has a single guard at a time and two siblings
+ * can't both be taken from the same parent.
+ * @warning LockRanked() starts a new chain and knows nothing about the chains the thread holds already: the ranks
+ * are checked only along one chain, so all the ranked locks a thread holds at once must come from one chain.
+ * @example:
+ *      RankedMutex<1> accounts;
+ *      RankedMutex<2> journal;
+ *
+ *      auto accountsLock = LockRanked(accounts);
+ *      auto journalLock = std::move(accountsLock).lock(journal);    // OK: 2 > 1, journalLock holds both
+ *      // auto bad = std::move(journalLock).lock(accounts);          // Doesn't compile: 1 <= 2
+ *      // auto sibling = journalLock.lock(other);                    // Doesn't compile: the parent isn't consumed
+ */
+template<std::size_t Level, typename Mutex>
+class RankedMutex final {
+public:
+    static constexpr std::size_t LEVEL = Level;
+
+    explicit RankedMutex(): m_mutex() {}
+
+    RankedMutex(const RankedMutex& ) = delete;
+    RankedMutex& operator=(const RankedMutex& ) = delete;
+
+private:
+    template<typename OtherMutex, std::size_t ... Levels>
+    friend class BasicRankedLock;
+
+    friend BasicRankedLock<Mutex, Level> LockRanked<Level, Mutex>(RankedMutex<Level, Mutex>& mutex);
+
+    Mutex m_mutex;
+};
+
+/**
+ * @brief RAII guard which owns the mutexes of all the ranks in Levels, they are released in the reverse order.
+ * @details lock() moves the mutexes of the guard to the guard of the next rank, a consumed guard owns nothing and
+ * locking through it again panics.
+ */
+template<typename Mutex, std::size_t ... Levels>
+class BasicRankedLock final {
+public:
+    static constexpr std::size_t MAX_RANK = __details::MaxRank<Levels ...>;
+
+    BasicRankedLock(const BasicRankedLock& ) = delete;
+    BasicRankedLock& operator=(const BasicRankedLock& ) = delete;
+    BasicRankedLock& operator=(BasicRankedLock&& ) = delete;
+
+    BasicRankedLock(BasicRankedLock&& other) noexcept:
+    m_mutexes(std::exchange(other.m_mutexes, MutexListType{})) {}
+    ~BasicRankedLock() { unlock(); }
+
+    template<std::size_t Next>
+    requires __details::CanLockRank<Next, Levels ...>
+    [[nodiscard]] BasicRankedLock<Mutex, Levels ..., Next> lock(RankedMutex<Next, Mutex>& mutex) && {
+        PANIC(!ownsLock());
+        return BasicRankedLock<Mutex, Levels ..., Next>{ std::exchange(m_mutexes, MutexListType{}), mutex.m_mutex };
+    }
+
+    void unlock() {
+        for (auto it = m_mutexes.rbegin(); it != m_mutexes.rend(); ++it) {
+            if (*it) {
+                (*it)->unlock();
+                *it = nullptr;
+            }
+        }
+    }
+
+    bool ownsLock() const { return m_mutexes.back() != nullptr; }
+
+private:
+    template<typename OtherMutex, std::size_t ... OtherLevels>
+    friend class BasicRankedLock;
+
+    template<std::size_t Level, typename OtherMutex>
+    friend BasicRankedLock<OtherMutex, Level> LockRanked(RankedMutex<Level, OtherMutex>& mutex);
+
+    using MutexListType = std::array<Mutex*, sizeof...(Levels)>;
+
+    explicit BasicRankedLock(Mutex& mutex): m_mutexes{ &mutex } { mutex.lock(); }
+
+    template<std::size_t ... Indexes>
+    explicit BasicRankedLock(const std::array<Mutex*, sizeof...(Levels) - 1>& held, Mutex& mutex,
+        std::index_sequence<Indexes ...>):
+    m_mutexes{ held[Indexes] ..., &mutex } {
+        mutex.lock();
+    }
+
+    explicit BasicRankedLock(const std::array<Mutex*, sizeof...(Levels) - 1>& held, Mutex& mutex):
+    BasicRankedLock(held, mutex, std::make_index_sequence<sizeof...(Levels) - 1>{}) {}
+
+    MutexListType m_mutexes;
+};
+
+template<std::size_t Level, typename Mutex>
+[[nodiscard]] BasicRankedLock<Mutex, Level> LockRanked(RankedMutex<Level, Mutex>& mutex)
+{
+    return BasicRankedLock<Mutex, Level>{ mutex.m_mutex };
+}
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_RANKED_MUTEX_H
@@ -0,0 +1,116 @@
+#ifndef CONCURRENCY_RCU_SYNC_H
+#define CONCURRENCY_RCU_SYNC_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "include/concurrency/epoch_domain.h"
+#include "include/concurrency/sync.h"
+
+namespace atom::concurrency {
+
+/**
+ * @brief Read-copy-update counterpart of MutableSync for large read-mostly objects (routing tables, flag maps).
+ * @details The value lives on the heap behind an atomic pointer. A reader enters the EpochDomain and gets a
+ * Snapshot: a const T* which stays valid for the lifetime of the snapshot whatever the writers do, so a read
+ * neither copies T nor allocates nor writes a shared cache line. A writer copies the current version, updates the
+ * copy and publishes it with a pointer swap (copy-and-swap), the replaced version is retired to the domain and
+ * deleted once no snapshot can see it. Writers are serialized by a mutex, readers never wait for them.
+ * @warning A Snapshot is a read-side critical section: keep it short, a long-lived one holds back the reclamation
+ * of every object retired to the domain.
+ * @example
+ *      RcuSync<RoutingTable> routes{ loadRoutes() };
+ *
+ *      auto snapshot = routes.read();                                 // Readers
+ *      const auto next = snapshot->lookup(address);
+ *
+ *      routes.accessMutable([](RoutingTable& table) { table.add(route); });   // Writers
+ */
+template<typename T>
+class RcuSync final {
+public:
+    using ValueType = T;
+    using MutableValueRefType = ValueType&;
+    using ImmutableValueRefType = const ValueType&;
+
+    /**
+     * @brief Pins a version of the value, it is readable while the snapshot lives.
+     */
+    class Snapshot final {
+    public:
+        explicit Snapshot(EpochDomain& domain, const std::atomic<const T*>& value):
+        m_guard(domain),
+        m_value(value.load()) {}
+
+        Snapshot(const Snapshot& ) = delete;
+        Snapshot& operator=(const Snapshot& ) = delete;
+
+        inline const T* get() const { return m_value; }
+        inline const T& operator*() const { return *m_value; }
+        inline const T* operator->() const { return m_value; }
+
+    private:
+        EpochDomain::Guard m_guard;
+        const T* m_value;
+    };
+
+    template<typename ... Args>
+    requires (std::is_constructible_v<T, Args ...>)
+    RcuSync(Args&& ... args): RcuSync(EpochDomain::instance(), std::forward<Args>(args) ...) {}
+
+    template<typename ... Args>
+    requires (std::is_constructible_v<T, Args ...>)
+    RcuSync(EpochDomain& domain, Args&& ... args):
+    m_domain(domain),
+    m_value(new T(std::forward<Args>(args) ...)),
+    m_writerMutex() {}
+
+    // Snapshots taken before the destruction stay valid, the last version is retired as well
+    ~RcuSync() { m_domain.retire(m_value.load()); }
+
+    RcuSync(const RcuSync& ) = delete;
+    RcuSync& operator=(const RcuSync& ) = delete;
+
+    [[nodiscard]] inline Snapshot read() const { return Snapshot{ m_domain, m_value }; }
+
+    template<typename Func>
+    inline void accessImmutable(Func f) const {
+        static_assert(__details::IsCallableWithConstRef<T, Func>::value, "Func must accept const T&");
+        const auto snapshot = read();
+        f(*snapshot);
+    }
+
+    /**
+     * @brief Copy-and-swap update, f gets a private copy of the current version which then replaces it.
+     */
+    template<typename Func>
+    void accessMutable(Func f) {
+        std::lock_guard lock{ m_writerMutex };
+        // An exception from f leaves the current version in place and frees the copy
+        auto copy = std::make_unique<T>(*m_value.load(std::memory_order_relaxed));
+        f(*copy);
+        publish(copy.release());
+    }
+
+    void setValue(T newValue) {
+        auto* value = new T(std::move(newValue));
+        std::lock_guard lock{ m_writerMutex };
+        publish(value);
+    }
+
+    inline T getValue() const { return *read(); }
+
+private:
+    inline void publish(const T* value) { m_domain.retire(m_value.exchange(value)); }
+
+    EpochDomain& m_domain;
+    std::atomic<const T*> m_value;
+    std::mutex m_writerMutex;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_RCU_SYNC_H
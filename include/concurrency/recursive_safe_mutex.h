@@ -0,0 +1,130 @@
+#ifndef CONCURRENCY_RECURSIVE_SAFE_MUTEX_H
+#define CONCURRENCY_RECURSIVE_SAFE_MUTEX_H
+
+#include "include/concurrency/safe_mutex.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
+#include <string_view>
+
+namespace atom::concurrency {
+
+/**
+ * @brief Re-entrant SafeMutex: the owning LockStory may lock it again, it is released by the matching last unlock.
+ * @details The mutex keeps its owner story and the re-entry depth next to an inner SafeMutex. A re-entry is a compare
+ * of the owner with the caller's story and an increment, without the inner mutex and without the lock order graph:
+ * only the first acquisition goes through SafeMutex and so takes part in the lock order tracking, the LockStory holds
+ * the mutex once whatever the depth is.
+ * The owner is compared by the story, so lock() and lock(LockStory::current()) are the same owner, while two
+ * different stories of one thread are two different owners (the second one blocks, as with SafeMutex).
+ * @example
+ *      RecursiveSafeMutex mutex;
+ *
+ *      void update() {
+ *          std::lock_guard lock{ mutex };
+ *          validate();                      // Re-enters the mutex
+ *      }
+ *
+ *      void validate() {
+ *          std::lock_guard lock{ mutex };
+ *      }
+ */
+class RecursiveSafeMutex final {
+public:
+    explicit RecursiveSafeMutex(std::string_view name, WaitPolicy policy = WaitPolicy::Fifo):
+    m_mutex(name, policy),
+    m_owner(nullptr),
+    m_depth(0) {}
+
+    explicit RecursiveSafeMutex(WaitPolicy policy = WaitPolicy::Fifo,
+        const std::source_location& location = std::source_location::current()):
+    m_mutex(policy, location),
+    m_owner(nullptr),
+    m_depth(0) {}
+
+    RecursiveSafeMutex(const RecursiveSafeMutex& ) = delete;
+    RecursiveSafeMutex& operator=(const RecursiveSafeMutex& ) = delete;
+
+    inline std::uint32_t id() const { return m_mutex.id(); }
+
+    /**
+     * @brief Re-entry depth, it is meaningful only for the owner (0 if the caller doesn't own the mutex).
+     */
+    inline std::size_t depth(const LockStory& lockStory) const { return isOwner(lockStory) ? m_depth : 0; }
+
+    inline void lock(LockStory& lockStory) {
+        if (isOwner(lockStory)) {
+            ++m_depth;
+            return;
+        }
+
+        m_mutex.lock(lockStory);
+        own(lockStory);
+    }
+
+    inline void unlock(LockStory& lockStory) {
+        assert(isOwner(lockStory) && m_depth > 0);
+        if (--m_depth == 0) {
+            m_owner.store(nullptr, std::memory_order_relaxed);
+            m_mutex.unlock(lockStory);
+        }
+    }
+
+    inline LockResultType tryLock(LockStory& lockStory) {
+        return reenterOr(lockStory, [&] { return m_mutex.tryLock(lockStory); });
+    }
+
+    template<typename Rep, typename Period>
+    inline LockResultType tryLockFor(LockStory& lockStory, const std::chrono::duration<Rep, Period>& timeout) {
+        return reenterOr(lockStory, [&] { return m_mutex.tryLockFor(lockStory, timeout); });
+    }
+
+    template<typename Clock, typename Duration>
+    inline LockResultType tryLockUntil(LockStory& lockStory, const std::chrono::time_point<Clock, Duration>& deadline) {
+        return reenterOr(lockStory, [&] { return m_mutex.tryLockUntil(lockStory, deadline); });
+    }
+
+    /**
+     * @brief std::Lockable interface backed by LockStory::current().
+     */
+    inline void lock() { lock(LockStory::current()); }
+    inline void unlock() { unlock(LockStory::current()); }
+    inline bool try_lock() { return tryLock(LockStory::current()).isOk(); }
+
+private:
+    // Only the owner can find its own story in m_owner, for everybody else it is a foreign or null pointer
+    inline bool isOwner(const LockStory& lockStory) const {
+        return m_owner.load(std::memory_order_relaxed) == &lockStory;
+    }
+
+    inline void own(const LockStory& lockStory) {
+        m_owner.store(&lockStory, std::memory_order_relaxed);
+        m_depth = 1;
+    }
+
+    template<typename Func>
+    inline LockResultType reenterOr(LockStory& lockStory, Func acquire) {
+        if (isOwner(lockStory)) {
+            ++m_depth;
+            return LockResultType::onOk();
+        }
+
+        auto result = acquire();
+        if (result.isOk()) {
+            own(lockStory);
+        }
+        return result;
+    }
+
+    SafeMutex m_mutex;
+    std::atomic<const LockStory*> m_owner;
+    std::size_t m_depth; // Accessed by the owner only
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_RECURSIVE_SAFE_MUTEX_H
@@ -0,0 +1,47 @@
+#ifndef CONCURRENCY_RUNTIME_CHECKS_H
+#define CONCURRENCY_RUNTIME_CHECKS_H
+
+#include <atomic>
+
+// The checked implementations of Sync, Owner and the Safe* locks are compiled into debug builds and into release
+// builds with ATOM_RUNTIME_CHECKS (CMake option ENABLE_RUNTIME_CHECKS), the plain release build has none of them
+#if !defined(NDEBUG) || defined(ATOM_RUNTIME_CHECKS)
+#define ATOM_CHECKED_BUILD
+#endif
+
+namespace atom::concurrency {
+
+/**
+ * @brief Switch of the checks in the checked implementations.
+ * @details Debug builds always check and plain release builds never do, the switch is a constant there. A release
+ * build with ATOM_RUNTIME_CHECKS is the same optimized binary either way: the checks are on if the
+ * ATOM_RUNTIME_CHECKS environment variable is set to a non-zero value at start-up or after setEnabled(true).
+ * Switched off, a checked access costs one relaxed load of the flag and a branch which is always predicted the
+ * same way, the checked path is laid out as the unlikely one, and SafeMutex feeds the LockSampler as in plain
+ * release, so the sampled lock order checking is still available. It is not free against a plain release build
+ * though (bench_runtime_checks.cpp, x86-64): a MutableSync access goes from 0.7 to 1.7 ns, since the value escapes
+ * into the out-of-line checked path and is no longer kept in a register, and two nested SafeMutex locks go from 16
+ * to 38 ns, since the checked SafeMutex is a CAS on its owner word per lock and per unlock where the plain one is a
+ * std::timed_mutex. Build with ATOM_RUNTIME_CHECKS only where this is acceptable.
+ * @warning Switch the checks only while no checked object is in use (no Safe* lock is held and no Ref is alive):
+ * the bookkeeping done with the checks on is not undone with them off and vice versa.
+ * @example ATOM_RUNTIME_CHECKS=1 ./service   # the lock order and the Sync/Owner access checks are on
+ */
+class RuntimeChecks final {
+public:
+#if !defined(NDEBUG)
+    static constexpr bool enabled() { return true; }
+#elif defined(ATOM_RUNTIME_CHECKS)
+    static inline bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+private:
+    static std::atomic<bool> s_enabled;
+#else
+    static constexpr bool enabled() { return false; }
+#endif
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_RUNTIME_CHECKS_H
@@ -0,0 +1,177 @@
+#ifndef CONCURRENCY_SAFE_CONDITION_VARIABLE_H
+#define CONCURRENCY_SAFE_CONDITION_VARIABLE_H
+
+#include "include/concurrency/safe_mutex.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <utility>
+
+namespace atom::concurrency {
+
+/**
+ * @brief Condition variable which waits on a SafeMutex held by a LockStory.
+ * @details The wait releases the mutex through SafeMutex::unlock(), so the mutex leaves the LockStory for the time
+ * of the wait, and acquires it back before returning, so it re-enters the story. The waiting thread therefore isn't
+ * reported as holding the mutex, and the re-acquisition takes part in the lock order check as any other lock.
+ *
+ * Notifications use wait morphing: a notified waiter is not woken up to contend for the mutex held by the notifier,
+ * its wait node is moved to the wait list of the mutex instead, and the waiter wakes up once the mutex is handed off
+ * to it. notifyAll() thus queues all waiters behind the mutex and they run one by one without a thundering herd.
+ * Only a notification which finds the mutex free wakes the waiter right away, so notify while holding the mutex.
+ *
+ * A condition variable serves a single mutex, the first wait binds it (waiting with another mutex is a PANIC), and
+ * the mutex must outlive it. In release builds without ATOM_RUNTIME_CHECKS it is a std::condition_variable_any on the SafeMutex.
+ * @example
+ *      SafeMutex mutex;
+ *      SafeConditionVariable condVar;
+ *      std::queue<Task> tasks;
+ *
+ *      void push(Task task) {
+ *          std::lock_guard lock{ mutex };
+ *          tasks.push(std::move(task));
+ *          condVar.notifyOne();
+ *      }
+ *
+ *      Task pop() {
+ *          auto& lockStory = LockStory::current();
+ *          mutex.lock(lockStory);
+ *          condVar.wait(mutex, lockStory, [] { return !tasks.empty(); });
+ *          auto task = std::move(tasks.front());
+ *          tasks.pop();
+ *          mutex.unlock(lockStory);
+ *          return task;
+ *      }
+ */
+class SafeConditionVariable final {
+public:
+    using ClockType = SafeMutex::ClockType;
+
+    explicit SafeConditionVariable();
+    ~SafeConditionVariable();
+
+    SafeConditionVariable(const SafeConditionVariable& ) = delete;
+    SafeConditionVariable& operator=(const SafeConditionVariable& ) = delete;
+
+    void notifyOne();
+    void notifyAll();
+
+    /**
+     * @brief The mutex must be held by the LockStory, it is held again when the wait returns (also on a timeout).
+     */
+    inline void wait(SafeMutex& mutex, LockStory& lockStory) { waitUntilImpl(mutex, lockStory, nullptr); }
+
+    template<typename Predicate>
+    void wait(SafeMutex& mutex, LockStory& lockStory, Predicate predicate);
+
+    template<typename Rep, typename Period>
+    std::cv_status waitFor(SafeMutex& mutex, LockStory& lockStory, const std::chrono::duration<Rep, Period>& timeout);
+
+    template<typename Rep, typename Period, typename Predicate>
+    bool waitFor(SafeMutex& mutex, LockStory& lockStory, const std::chrono::duration<Rep, Period>& timeout,
+        Predicate predicate);
+
+    template<typename Clock, typename Duration>
+    std::cv_status waitUntil(SafeMutex& mutex, LockStory& lockStory,
+        const std::chrono::time_point<Clock, Duration>& deadline);
+
+    template<typename Clock, typename Duration, typename Predicate>
+    bool waitUntil(SafeMutex& mutex, LockStory& lockStory, const std::chrono::time_point<Clock, Duration>& deadline,
+        Predicate predicate);
+
+private:
+    template<typename Clock, typename Duration>
+    static inline ClockType::time_point ToDeadline(const std::chrono::time_point<Clock, Duration>& deadline) {
+        return ClockType::now() + std::chrono::ceil<ClockType::duration>(deadline - Clock::now());
+    }
+
+    // Returns false if the deadline has expired, the mutex is re-acquired in either case
+    bool waitUntilImpl(SafeMutex& mutex, LockStory& lockStory, const ClockType::time_point* deadline);
+
+#ifndef ATOM_CHECKED_BUILD
+    std::condition_variable_any m_condVar;
+#else
+    void bind(SafeMutex& mutex);
+    void notify(bool all);
+
+    std::atomic<SafeMutex*> m_mutex;
+    SafeMutex::WaitList m_waiters; // Guarded by the inner mutex of *m_mutex
+#endif
+};
+
+#ifndef ATOM_CHECKED_BUILD
+
+inline SafeConditionVariable::SafeConditionVariable(): m_condVar() {}
+inline SafeConditionVariable::~SafeConditionVariable() = default;
+
+inline void SafeConditionVariable::notifyOne()
+{
+    m_condVar.notify_one();
+}
+
+inline void SafeConditionVariable::notifyAll()
+{
+    m_condVar.notify_all();
+}
+
+inline bool SafeConditionVariable::waitUntilImpl(SafeMutex& mutex, LockStory& /*lockStory*/,
+    const ClockType::time_point* const deadline)
+{
+    if (!deadline) {
+        m_condVar.wait(mutex);
+        return true;
+    }
+    return m_condVar.wait_until(mutex, *deadline) == std::cv_status::no_timeout;
+}
+
+#endif //! ifndef ATOM_CHECKED_BUILD
+
+template<typename Predicate>
+void SafeConditionVariable::wait(SafeMutex& mutex, LockStory& lockStory, Predicate predicate)
+{
+    while (!predicate()) {
+        waitUntilImpl(mutex, lockStory, nullptr);
+    }
+}
+
+template<typename Rep, typename Period>
+std::cv_status SafeConditionVariable::waitFor(SafeMutex& mutex, LockStory& lockStory,
+    const std::chrono::duration<Rep, Period>& timeout)
+{
+    const auto deadline = ClockType::now() + std::chrono::ceil<ClockType::duration>(timeout);
+    return waitUntilImpl(mutex, lockStory, &deadline) ? std::cv_status::no_timeout : std::cv_status::timeout;
+}
+
+template<typename Rep, typename Period, typename Predicate>
+bool SafeConditionVariable::waitFor(SafeMutex& mutex, LockStory& lockStory,
+    const std::chrono::duration<Rep, Period>& timeout, Predicate predicate)
+{
+    return waitUntil(mutex, lockStory, ClockType::now() + std::chrono::ceil<ClockType::duration>(timeout),
+        std::move(predicate));
+}
+
+template<typename Clock, typename Duration>
+std::cv_status SafeConditionVariable::waitUntil(SafeMutex& mutex, LockStory& lockStory,
+    const std::chrono::time_point<Clock, Duration>& deadline)
+{
+    const auto steadyDeadline = ToDeadline(deadline);
+    return waitUntilImpl(mutex, lockStory, &steadyDeadline) ? std::cv_status::no_timeout : std::cv_status::timeout;
+}
+
+template<typename Clock, typename Duration, typename Predicate>
+bool SafeConditionVariable::waitUntil(SafeMutex& mutex, LockStory& lockStory,
+    const std::chrono::time_point<Clock, Duration>& deadline, Predicate predicate)
+{
+    const auto steadyDeadline = ToDeadline(deadline);
+    while (!predicate()) {
+        if (!waitUntilImpl(mutex, lockStory, &steadyDeadline)) {
+            return predicate();
+        }
+    }
+    return true;
+}
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_SAFE_CONDITION_VARIABLE_H
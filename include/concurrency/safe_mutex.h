@@ -2,19 +2,82 @@
 #define CONCURRENCY_SAFE_MUTEX_H
 
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
-#include <list>
 #include <unordered_set>
 #include <unordered_map>
-#include <queue>
+#include <vector>
+#include <array>
 #include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <source_location>
+#include <span>
+#include <type_traits>
+#include <string>
+#include <string_view>
 #include <cassert>
 
 #include <iostream>
 
+#include "include/concurrency/lock_profiler.h"
+#include "include/concurrency/lock_sampler.h"
+#include "include/concurrency/lock_tracer.h"
+#include "include/concurrency/lock_watchdog.h"
+#include "include/concurrency/runtime_checks.h"
+#include "include/utils/result.h"
+
 namespace atom::concurrency {
 
-#ifdef NDEBUG
+enum class LockError : std::uint8_t {
+    WouldBlock, // The mutex is held by another owner (tryLock only)
+    Timeout,    // The deadline has expired before the mutex was released
+    Deadlock    // Acquiring the mutex would deadlock (already held or the lock order closes a cycle)
+};
+
+using LockResultType = utils::Result<void, LockError>;
+
+/**
+ * @brief Hand-off policy of a contended SafeMutex.
+ */
+enum class WaitPolicy : std::uint8_t {
+    Fifo,   // The mutex is handed off to a parked waiter, newcomers can't overtake the queue
+    Barging // A released mutex is free for anybody, a woken waiter competes with newcomers and spinners
+};
+
+class SafeMutex;
+class LockStory;
+class SafeConditionVariable;
+class AsyncSafeMutex;
+
+/**
+ * @brief Acquires all mutexes as one step without a lock order deadlock.
+ * @details The mutexes are taken in the canonical global order (ascending SafeMutex::id()) with try-and-back-off:
+ * the first mutex is locked blocking and the rest only tried, on a failure everything is released and the attempt
+ * restarts blocking on the mutex which was busy. Two groups taking overlapping mutexes therefore never deadlock on
+ * each other, whatever the order of the arguments.
+ * The group enters the LockStory at once. Only the (held -> member) edges from the locks held before the group are
+ * checked against the lock order graph, the members are not ordered between themselves.
+ */
+void LockAll(LockStory& lockStory, std::span<SafeMutex* const> mutexes);
+void UnlockAll(LockStory& lockStory, std::span<SafeMutex* const> mutexes);
+
+namespace __details {
+
+/**
+ * @brief Lock ids, unique among the live locks: the ids of destroyed locks are reused, so they stay small.
+ * @details A thread reuses the ids it has released itself, the shared free list is touched only when the cache of
+ * the thread runs empty or full. An id enters the LockOrderGraph only with its first edge.
+ */
+std::uint32_t GenerateLockId();
+void ReleaseLockId(std::uint32_t id);
+
+class QueueLockChecks;
+
+} //! namespace __details
+
+#ifndef ATOM_CHECKED_BUILD
 
 class SafeMutex;
 class LockStory;
@@ -24,60 +87,410 @@ public:
     using GraphType = std::unordered_map<const SafeMutex*, const SafeMutex*>;
     using StoryListType = std::vector<const SafeMutex*>;
 
-    static constexpr auto DEFAULT_STORY_LITS_SIZE = 0;
+    static constexpr std::size_t MAX_STORY_SIZE = 0;
 
-    explicit LockStory(std::size_t /*storySizeHint*/ = DEFAULT_STORY_LITS_SIZE) {}
+    explicit LockStory() {}
+
+    static LockStory& current() { thread_local LockStory lockStory; return lockStory; }
 };
 
+// Release variant: there is no LockStory, the lock order is checked only by the LockSampler (off by default)
 class SafeMutex final {
 public:
-    explicit SafeMutex(): m_mutex() {}
-    inline void lock(LockStory& lockStory) { m_mutex.lock(); }
-    inline void unlock(LockStory& lockStory) { m_mutex.unlock(); }
+    using ClockType = std::chrono::steady_clock;
+
+    // std::timed_mutex already lets newcomers barge and parks in the kernel, so the policy is not used here
+    explicit SafeMutex(std::string_view name, WaitPolicy /*policy*/ = WaitPolicy::Fifo):
+    m_id(__details::GenerateLockId()),
+    m_mutex() {
+        initProfile(name);
+    }
+
+    explicit SafeMutex(WaitPolicy /*policy*/ = WaitPolicy::Fifo,
+        const std::source_location& location = std::source_location::current()):
+    m_id(__details::GenerateLockId()),
+    m_mutex() {
+        initProfile(location);
+    }
+
+    ~SafeMutex() { __details::ReleaseLockId(m_id); }
+
+    SafeMutex(const SafeMutex& ) = delete;
+    SafeMutex& operator=(const SafeMutex& ) = delete;
+
+    inline std::uint32_t id() const { return m_id; }
+
+    inline void lock(LockStory& ) { lock(); }
+    inline void unlock(LockStory& ) { unlock(); }
+
+    inline LockResultType tryLock(LockStory& ) {
+        return try_lock() ? LockResultType::onOk() : LockResultType::onError(LockError::WouldBlock);
+    }
+
+    template<typename Rep, typename Period>
+    inline LockResultType tryLockFor(LockStory& , const std::chrono::duration<Rep, Period>& timeout) {
+        return sampledAcquire([&] { return m_mutex.try_lock_for(timeout); }) ?
+            LockResultType::onOk() : LockResultType::onError(LockError::Timeout);
+    }
+
+    template<typename Clock, typename Duration>
+    inline LockResultType tryLockUntil(LockStory& , const std::chrono::time_point<Clock, Duration>& deadline) {
+        return sampledAcquire([&] { return m_mutex.try_lock_until(deadline); }) ?
+            LockResultType::onOk() : LockResultType::onError(LockError::Timeout);
+    }
+
+    inline void lock() { sampledAcquire([this] { m_mutex.lock(); return true; }); }
+    inline void unlock() { LockSampler::onReleased(m_id); onRelease(); m_mutex.unlock(); }
+
+    inline bool try_lock() {
+        const auto acquired = m_mutex.try_lock();
+        if (acquired) {
+            onAcquire(false, ClockType::duration::zero());
+            LockSampler::onAcquired(m_id);
+        }
+        return acquired;
+    }
 
 private:
-    std::mutex m_mutex;
+    friend void LockAll(LockStory& lockStory, std::span<SafeMutex* const> mutexes);
+
+    inline void acquire(LockStory& ) { lock(); }
+    inline bool tryAcquire(LockStory& ) { return try_lock(); }
+    inline void release(LockStory& ) { unlock(); }
+
+    // Blocking acquisitions are checked by the LockSampler, a failed try can't deadlock
+    template<typename Func>
+    inline bool sampledAcquire(Func acquire) {
+        LockSampler::onAcquiring(m_id);
+        const bool acquired = profiledAcquire(acquire);
+        if (!acquired) {
+            LockSampler::onReleased(m_id);
+        }
+        return acquired;
+    }
+
+#ifdef ATOM_LOCK_PROFILING
+    template<typename T>
+    inline void initProfile(const T& name) { m_profile = std::make_unique<LockProfile>(LockProfile::NameOf(name)); }
+
+    std::unique_ptr<LockProfile> m_profile;
+#else
+    template<typename T>
+    inline void initProfile(const T& ) {}
+#endif //! ifdef ATOM_LOCK_PROFILING
+
+#if defined(ATOM_LOCK_PROFILING) || defined(ATOM_LOCK_TRACING)
+    inline void onAcquire(bool contended, ClockType::duration waitTime) {
+#ifdef ATOM_LOCK_PROFILING
+        m_profile->onAcquire(contended, waitTime);
+#endif
+#ifdef ATOM_LOCK_TRACING
+        LockTracer::record(LockEventType::Acquire, m_id, waitTime);
+#endif
+    }
+
+    inline void onRelease() {
+#ifdef ATOM_LOCK_PROFILING
+        m_profile->onRelease();
+#endif
+#ifdef ATOM_LOCK_TRACING
+        LockTracer::record(LockEventType::Release, m_id, ClockType::duration::zero());
+#endif
+    }
+
+    template<typename Func>
+    inline bool profiledAcquire(Func acquire) {
+        if (m_mutex.try_lock()) {
+            onAcquire(false, ClockType::duration::zero());
+            return true;
+        }
+
+        const auto waitStart = ClockType::now();
+        const bool acquired = acquire();
+        if (acquired) {
+            onAcquire(true, ClockType::now() - waitStart);
+        }
+        return acquired;
+    }
+#else
+    inline void onAcquire(bool , ClockType::duration ) {}
+    inline void onRelease() {}
+
+    template<typename Func>
+    inline bool profiledAcquire(Func acquire) { return acquire(); }
+#endif //! if defined(ATOM_LOCK_PROFILING) || defined(ATOM_LOCK_TRACING)
+
+    std::uint32_t m_id;
+    std::timed_mutex m_mutex;
 };
 
 #else
 
 class SafeMutex;
+class SafeSharedMutex;
 class LockStory;
 
+enum class LockMode : std::uint8_t {
+    Exclusive,
+    Shared
+};
+
 class LockStory final {
 public:
     using GraphType = std::unordered_map<const SafeMutex*, const SafeMutex*>;
     using StoryListType = std::vector<const SafeMutex*>;
 
-    static constexpr auto DEFAULT_STORY_LITS_SIZE = 5;
+    struct HeldLock final {
+        std::uint32_t id;
+        LockMode mode;
+    };
+
+    /**
+     * @brief Maximum number of locks held at once by one story.
+     * @details The story is stored inline and is never reallocated: a LIFO release is an O(1) pop and only an out
+     * of order release has to shift the tail.
+     */
+    static constexpr std::size_t MAX_STORY_SIZE = 16;
 
-    explicit LockStory(std::size_t storySizeHint = DEFAULT_STORY_LITS_SIZE);
+    using HeldListType = std::array<HeldLock, MAX_STORY_SIZE>;
+
+    explicit LockStory();
+
+    LockStory(const LockStory& ) = delete;
+    LockStory& operator=(const LockStory& ) = delete;
+
+    /**
+     * @brief Returns the implicit story of the calling thread used by the zero-argument lock()/unlock()/try_lock().
+     */
+    static LockStory& current();
+
+    std::size_t size() const;
+    bool empty() const;
 
 private:
     friend SafeMutex;
+    friend SafeSharedMutex;
+    friend SafeConditionVariable;
+    friend AsyncSafeMutex;
+    friend LockWatchdog;
+    friend __details::QueueLockChecks;
+    friend void LockAll(LockStory& lockStory, std::span<SafeMutex* const> mutexes);
+
+    void add(std::uint32_t id, LockMode mode);
+    void remove(std::uint32_t id);
+    const HeldLock* find(std::uint32_t id) const;
 
-    void add(const SafeMutex& safeMutex);
-    void remove(const SafeMutex& safeMutex);
+    /**
+     * @brief Records the (held -> lock) edges in the global lock order graph.
+     * @return false if acquiring the lock could deadlock: it is already held by this story or the new edges
+     * close a cycle of any length in the lock order graph.
+     */
+    bool recordLockOrder(std::uint32_t id) const;
 
-    StoryListType m_storage;
+    HeldListType m_storage;
+    std::size_t m_size;
 };
 
 class SafeMutex final {
 public:
-    explicit SafeMutex();
+    /**
+     * @brief The name (or the construction site) identifies the mutex in the LockProfiler report.
+     * @details It is stored only in builds with ATOM_LOCK_PROFILING.
+     */
+    explicit SafeMutex(std::string_view name, WaitPolicy policy = WaitPolicy::Fifo);
+    explicit SafeMutex(WaitPolicy policy = WaitPolicy::Fifo,
+        const std::source_location& location = std::source_location::current());
+    ~SafeMutex();
+
+    SafeMutex(const SafeMutex& ) = delete;
+    SafeMutex& operator=(const SafeMutex& ) = delete;
+
+    using ClockType = std::chrono::steady_clock;
+
+    /**
+     * @brief Process-wide id which defines the canonical order of LockAll(), it is unique among live mutexes.
+     */
+    std::uint32_t id() const;
+
     void lock(LockStory& lockStory);
     void unlock(LockStory& lockStory);
 
+    /**
+     * @brief Non-panicking acquisition: a detected deadlock is returned as LockError::Deadlock instead of aborting
+     * the process, and the wait is bounded by the deadline (LockError::Timeout).
+     * @details On any error the mutex is not held and the LockStory is left untouched.
+     */
+    LockResultType tryLock(LockStory& lockStory);
+
+    template<typename Rep, typename Period>
+    LockResultType tryLockFor(LockStory& lockStory, const std::chrono::duration<Rep, Period>& timeout);
+
+    template<typename Clock, typename Duration>
+    LockResultType tryLockUntil(LockStory& lockStory, const std::chrono::time_point<Clock, Duration>& deadline);
+
+    /**
+     * @brief std::Lockable interface backed by LockStory::current(), so SafeMutex can be used with std::scoped_lock,
+     * std::unique_lock and std::condition_variable_any.
+     */
+    void lock();
+    void unlock();
+    bool try_lock();
+
 private:
-    LockStory::GraphType m_graph;
-    LockStory* m_currentOwner;
-    std::queue<LockStory*, std::list<LockStory*>> m_waitQueue;
-    std::condition_variable m_condVar;
+    friend void LockAll(LockStory& lockStory, std::span<SafeMutex* const> mutexes);
+    friend SafeConditionVariable;
+
+    // m_state keeps the owner LockStory* and the HAS_WAITERS flag in the lowest (always zero) pointer bit.
+    // The uncontended acquire and release are a single CAS on it, the inner mutex is taken only by waiters.
+    static constexpr std::uintptr_t UNLOCKED_STATE = 0;
+    static constexpr std::uintptr_t HAS_WAITERS_FLAG = 1;
+
+    // A contended acquire spins for m_spinLimit iterations before it parks. The limit follows the number of
+    // iterations the successful spins needed (that is the hold time of the owner in pause units), and decays
+    // when spinning doesn't help, so long critical sections quickly stop burning CPU.
+    static constexpr std::uint32_t MIN_SPIN_LIMIT = 16;
+    static constexpr std::uint32_t MAX_SPIN_LIMIT = 4096;
+    static constexpr std::uint32_t INITIAL_SPIN_LIMIT = 128;
+
+    enum class WaitState : std::uint8_t {
+        Idle,      // Not in any wait list
+        Queued,    // In the wait list of the mutex
+        HandedOff, // Dequeued by unlockSlow
+        Waiting,   // In the wait list of a SafeConditionVariable
+        Notified   // Dequeued by a notify which found the mutex free, the waiter acquires it on its own
+    };
+
+    // A parked waiter, it lives on the waiter's stack for the duration of the wait, so the contended path never
+    // allocates. Each waiter sleeps on its own condition variable: unlockSlow wakes exactly the dequeued head.
+    // unlockSlow notifies outside of the inner mutex, so the woken waiter doesn't block on it right away, and
+    // the waiter keeps the node alive until the notifier has dropped the `notifying` flag.
+    struct WaitNode final {
+        WaitNode* prev = nullptr;
+        WaitNode* next = nullptr;
+        std::condition_variable condVar;
+        WaitState state = WaitState::Idle;
+        std::atomic<bool> notifying = false;
+        ClockType::time_point queuedAt{}; // When a condition waiter was moved onto the mutex, for the profiler
+    };
+
+    // Intrusive FIFO of wait nodes, the lists of the mutex and of its condition variables are guarded by m_mutex
+    struct WaitList final {
+        WaitNode* head = nullptr;
+        WaitNode* tail = nullptr;
+
+        void push(WaitNode& node, WaitState state);
+        void erase(WaitNode& node);
+        WaitNode* pop();
+    };
+
+    static std::uintptr_t ToState(const LockStory* owner);
+    static LockStory* ToOwner(std::uintptr_t state);
+
+    static ClockType::time_point WaitStart();
+
+    LockResultType tryLockUntilImpl(LockStory& lockStory, ClockType::time_point deadline);
+    void onAcquire(bool contended, ClockType::time_point waitStart);
+    void onRelease();
+    void checkLockOrder(const LockStory& lockStory) const;
+
+    // Ownership transfer only, without the lock order check and the LockStory bookkeeping
+    void acquire(LockStory& lockStory);
+    bool tryAcquire(LockStory& lockStory);
+    void release(LockStory& lockStory);
+
+    bool canTakeOver(std::uintptr_t state) const;
+    bool spin(LockStory& lockStory);
+    bool lockSlow(LockStory& lockStory, const ClockType::time_point* deadline);
+    void unlockSlow(LockStory& lockStory);
+
+    // Parks the node in the wait list (unless it is queued there already) until the mutex is acquired,
+    // m_mutex is held by `lock` on entry
+    bool lockQueued(LockStory& lockStory, WaitNode& node, std::unique_lock<std::mutex>& lock,
+        const ClockType::time_point* deadline);
+
+    // Wait morphing: moves a notified condition variable waiter to the wait list of the busy mutex, m_mutex is
+    // held. Returns false if the mutex is free, then the waiter must be woken up to take it.
+    bool enqueueNotified(WaitNode& node);
+    static void AwaitNotifier(const WaitNode& node);
+
+    std::uint32_t m_id;
+    WaitPolicy m_policy;
+    std::atomic<std::uint32_t> m_spinLimit;
+    std::atomic<std::uintptr_t> m_state;
+    WaitList m_waiters;
     std::mutex m_mutex;
-    bool m_flag;
+#ifdef ATOM_LOCK_PROFILING
+    std::unique_ptr<LockProfile> m_profile;
+#endif
+};
+
+template<typename Rep, typename Period>
+LockResultType SafeMutex::tryLockFor(LockStory& lockStory, const std::chrono::duration<Rep, Period>& timeout)
+{
+    return tryLockUntilImpl(lockStory, ClockType::now() + std::chrono::ceil<ClockType::duration>(timeout));
+}
+
+template<typename Clock, typename Duration>
+LockResultType SafeMutex::tryLockUntil(LockStory& lockStory, const std::chrono::time_point<Clock, Duration>& deadline)
+{
+    const auto timeout = std::chrono::ceil<ClockType::duration>(deadline - Clock::now());
+    return tryLockUntilImpl(lockStory, ClockType::now() + timeout);
+}
+
+#endif //! ifndef ATOM_CHECKED_BUILD
+
+template<typename ... Mutexes>
+requires (std::is_same_v<Mutexes, SafeMutex> && ...)
+void LockAll(LockStory& lockStory, Mutexes& ... mutexes)
+{
+    const std::array<SafeMutex*, sizeof...(Mutexes)> group{ &mutexes ... };
+    LockAll(lockStory, group);
+}
+
+template<typename ... Mutexes>
+requires (std::is_same_v<Mutexes, SafeMutex> && ...)
+void LockAll(Mutexes& ... mutexes)
+{
+    LockAll(LockStory::current(), mutexes ...);
+}
+
+/**
+ * @brief RAII guard over LockAll()/UnlockAll().
+ * @example:
+ *      SafeMutex from, to;
+ *      MultiLockGuard guard{ lockStory, from, to };   // Same as MultiLockGuard guard{ lockStory, to, from };
+ */
+template<std::size_t N>
+class MultiLockGuard final {
+public:
+    template<typename ... Mutexes>
+    requires (std::is_same_v<Mutexes, SafeMutex> && ...)
+    explicit MultiLockGuard(LockStory& lockStory, Mutexes& ... mutexes):
+    m_lockStory(lockStory),
+    m_mutexes{ &mutexes ... } {
+        LockAll(m_lockStory, m_mutexes);
+    }
+
+    template<typename ... Mutexes>
+    requires (std::is_same_v<Mutexes, SafeMutex> && ...)
+    explicit MultiLockGuard(Mutexes& ... mutexes): MultiLockGuard(LockStory::current(), mutexes ...) {}
+
+    ~MultiLockGuard() { UnlockAll(m_lockStory, m_mutexes); }
+
+    MultiLockGuard(const MultiLockGuard& ) = delete;
+    MultiLockGuard& operator=(const MultiLockGuard& ) = delete;
+
+private:
+    LockStory& m_lockStory;
+    std::array<SafeMutex*, N> m_mutexes;
 };
 
-#endif //! ifdef NDEBUG
+template<typename ... Mutexes>
+MultiLockGuard(LockStory& , Mutexes& ... ) -> MultiLockGuard<sizeof...(Mutexes)>;
+
+template<typename ... Mutexes>
+requires (std::is_same_v<Mutexes, SafeMutex> && ...)
+MultiLockGuard(Mutexes& ... ) -> MultiLockGuard<sizeof...(Mutexes)>;
 
 void MakeGraph(const LockStory::StoryListType& first, const LockStory::StoryListType& second, LockStory::GraphType& graph);
 bool CheckIntersections(const LockStory::GraphType& graph);
@@ -0,0 +1,99 @@
+#ifndef CONCURRENCY_SAFE_SHARED_MUTEX_H
+#define CONCURRENCY_SAFE_SHARED_MUTEX_H
+
+#include "include/concurrency/safe_mutex.h"
+#include "include/utils/cache_line.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+namespace atom::concurrency {
+
+namespace __details {
+
+/**
+ * @brief Writer-preferring reader-writer lock with distributed reader indicators.
+ * @details Every thread is bound to one of READER_SLOTS cache line padded counters, so readers running on different
+ * cores increment different cache lines and never bounce a shared line on the read acquire. A writer raises
+ * m_writer and then waits until every reader slot drains. Readers which see the raised flag step back and wait
+ * for the writer to leave, so a stream of readers can't starve the writer.
+ * @warning The shared lock must be released by the same thread which has acquired it.
+ */
+class DistributedSharedLock final {
+public:
+    static constexpr std::size_t READER_SLOTS = 16;
+
+    explicit DistributedSharedLock();
+
+    DistributedSharedLock(const DistributedSharedLock& ) = delete;
+    DistributedSharedLock& operator=(const DistributedSharedLock& ) = delete;
+
+    void lock();
+    void unlock();
+    void lockShared();
+    void unlockShared();
+
+private:
+    struct alignas(utils::CACHE_LINE_SIZE) ReaderSlot final {
+        std::atomic<std::uint32_t> readers{ 0 };
+    };
+
+    static std::size_t CurrentReaderSlot();
+
+    std::array<ReaderSlot, READER_SLOTS> m_readerSlots;
+    alignas(utils::CACHE_LINE_SIZE) std::atomic<bool> m_writer;
+    std::mutex m_writersMutex;
+};
+
+} //! namespace __details
+
+#ifndef ATOM_CHECKED_BUILD
+
+class SafeSharedMutex final {
+public:
+    explicit SafeSharedMutex(): m_lock() {}
+    inline void lock(LockStory& ) { m_lock.lock(); }
+    inline void unlock(LockStory& ) { m_lock.unlock(); }
+    inline void lockShared(LockStory& ) { m_lock.lockShared(); }
+    inline void unlockShared(LockStory& ) { m_lock.unlockShared(); }
+
+private:
+    __details::DistributedSharedLock m_lock;
+};
+
+#else
+
+/**
+ * @brief Shared/exclusive counterpart of SafeMutex.
+ * @details Shared and exclusive holds are recorded in the LockStory with their mode and take part in the global lock
+ * order graph the same way as SafeMutex does, so ordering cycles between SafeMutex and SafeSharedMutex are caught.
+ * Because writers are preferred, both an upgrade (exclusive lock while holding the shared one) and a recursive shared
+ * lock can deadlock, both of them are reported with PANIC.
+ */
+class SafeSharedMutex final {
+public:
+    explicit SafeSharedMutex();
+    ~SafeSharedMutex();
+
+    SafeSharedMutex(const SafeSharedMutex& ) = delete;
+    SafeSharedMutex& operator=(const SafeSharedMutex& ) = delete;
+
+    void lock(LockStory& lockStory);
+    void unlock(LockStory& lockStory);
+    void lockShared(LockStory& lockStory);
+    void unlockShared(LockStory& lockStory);
+
+private:
+    void checkLockOrder(const LockStory& lockStory, LockMode mode) const;
+
+    std::uint32_t m_id;
+    __details::DistributedSharedLock m_lock;
+};
+
+#endif //! ifndef ATOM_CHECKED_BUILD
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_SAFE_SHARED_MUTEX_H
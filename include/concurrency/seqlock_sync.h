@@ -0,0 +1,155 @@
+#ifndef CONCURRENCY_SEQLOCK_SYNC_H
+#define CONCURRENCY_SEQLOCK_SYNC_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "include/concurrency/sync.h"
+#include "include/utils/cpu_relax.h"
+
+namespace atom::concurrency {
+
+/**
+ * @brief Read-mostly counterpart of MutableSync for small trivially copyable values (quotes, counters, configs).
+ * @details The value is guarded by a sequence counter which is odd while a writer updates it. A reader copies the
+ * value optimistically between two loads of the counter and retries if a writer has been there in the meantime, so
+ * readers never write shared memory and don't slow each other down. Writers take the counter from even to odd with
+ * a CAS, which also serializes them, update the value and make the counter even again.
+ * The value is stored as an array of words accessed through std::atomic_ref, so a read racing with a write is a
+ * (discarded) torn copy rather than a data race. The functor of accessImmutable() gets a consistent private copy,
+ * the one of accessMutable() works on a private copy which is published when it returns and dropped if it throws.
+ * SeqlockSync is thread safe by itself, there are no checked-build checks as in MutableSync.
+ * @warning The functor of accessMutable() must not access the same SeqlockSync, the nested access spins forever.
+ * @example
+ *      SeqlockSync<Quote> quote{ Quote{ 100, 101 } };
+ *
+ *      quote.accessMutable([](Quote& quote) { quote.bid = 99; });   // Writer thread
+ *      const auto spread = quote.getValue().spread();               // Any number of reader threads
+ */
+template<typename T>
+requires (std::is_trivially_copyable_v<T>)
+class SeqlockSync final {
+public:
+    using ValueType = T;
+    using MutableValueRefType = ValueType&;
+    using ImmutableValueRefType = const ValueType&;
+    using SequenceType = std::uint64_t;
+
+    template<typename ... Args>
+    SeqlockSync(Args&& ... args): m_sequence(0), m_words() {
+        store(T(std::forward<Args>(args) ...));
+    }
+
+    SeqlockSync(const SeqlockSync& ) = delete;
+    SeqlockSync& operator=(const SeqlockSync& ) = delete;
+
+    template<typename Func>
+    inline void accessMutable(Func f) {
+        const WriteGuard guard{ *this };
+        auto value = load();
+        f(value);
+        store(value);
+    }
+
+    template<typename Func>
+    inline void accessImmutable(Func f) const {
+        static_assert(__details::IsCallableWithConstRef<T, Func>::value, "Func must accept const T&");
+        const auto value = getValue();
+        f(value);
+    }
+
+    inline void setValue(const T& newValue) {
+        const WriteGuard guard{ *this };
+        store(newValue);
+    }
+
+    T getValue() const {
+        while (true) {
+            const auto sequence = m_sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                utils::CpuRelax();
+                continue;
+            }
+
+            const auto value = load();
+            // Orders the relaxed loads of the value before the second load of the counter
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == sequence) {
+                return value;
+            }
+        }
+    }
+
+    /**
+     * @brief The number of completed writes.
+     */
+    inline SequenceType version() const { return m_sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    using WordType = std::uint64_t;
+    static constexpr std::size_t WORDS = (sizeof(T) + sizeof(WordType) - 1) / sizeof(WordType);
+
+    // Makes the counter even again however the write ends, otherwise a throwing functor would block everyone for good
+    class WriteGuard final {
+    public:
+        explicit WriteGuard(SeqlockSync& sync): m_sync(sync), m_sequence(sync.beginWrite()) {}
+        ~WriteGuard() { m_sync.endWrite(m_sequence); }
+
+        WriteGuard(const WriteGuard& ) = delete;
+        WriteGuard& operator=(const WriteGuard& ) = delete;
+
+    private:
+        SeqlockSync& m_sync;
+        const SequenceType m_sequence;
+    };
+
+    SequenceType beginWrite() {
+        auto sequence = m_sequence.load(std::memory_order_relaxed);
+        while (true) {
+            if (sequence & 1) {
+                utils::CpuRelax();
+                sequence = m_sequence.load(std::memory_order_relaxed);
+            } else if (m_sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        // The odd counter becomes visible before any word of the new value
+        std::atomic_thread_fence(std::memory_order_release);
+        return sequence;
+    }
+
+    inline void endWrite(const SequenceType sequence) { m_sequence.store(sequence + 2, std::memory_order_release); }
+
+    T load() const {
+        std::array<WordType, WORDS> words;
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            words[i] = std::atomic_ref<WordType>(m_words[i]).load(std::memory_order_relaxed);
+        }
+
+        std::array<std::byte, sizeof(T)> bytes;
+        std::memcpy(bytes.data(), words.data(), sizeof(T));
+        return std::bit_cast<T>(bytes);
+    }
+
+    void store(const T& value) {
+        std::array<WordType, WORDS> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            std::atomic_ref<WordType>(m_words[i]).store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<SequenceType> m_sequence;
+    alignas(std::atomic_ref<WordType>::required_alignment) mutable std::array<WordType, WORDS> m_words;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_SEQLOCK_SYNC_H
@@ -0,0 +1,181 @@
+#ifndef CONCURRENCY_STRAND_SYNC_H
+#define CONCURRENCY_STRAND_SYNC_H
+
+#include <atomic>
+#include <exception>
+#include <future>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "include/concurrency/sync.h"
+#include "include/utils/assertion.h"
+#include "include/utils/cache_line.h"
+
+namespace atom::concurrency {
+
+namespace __details {
+
+/**
+ * @brief Intrusive node of the StrandExecutor queue, run() executes and deletes the task.
+ */
+struct StrandTask {
+    std::atomic<StrandTask*> next = nullptr;
+    void (*run)(StrandTask* task) = nullptr;
+};
+
+/**
+ * @brief A thread which runs the posted tasks one at a time in the order of posting.
+ * @details The queue is an intrusive multi-producer single-consumer queue: posting is one exchange on the head and
+ * one store, with no lock and no allocation besides the task itself. The executor spins on an empty queue for a
+ * while, then sleeps until the next post, a post wakes it only if it has gone to sleep.
+ */
+class StrandExecutor final {
+public:
+    // The executor spins on an empty queue this many times before it goes to sleep
+    static constexpr std::uint32_t SPIN_LIMIT = 128;
+
+    explicit StrandExecutor();
+
+    /**
+     * @brief Runs the tasks posted before and joins the thread.
+     */
+    ~StrandExecutor();
+
+    StrandExecutor(const StrandExecutor& ) = delete;
+    StrandExecutor& operator=(const StrandExecutor& ) = delete;
+
+    void post(StrandTask* task);
+
+    inline bool isCurrentThread() const { return std::this_thread::get_id() == m_thread.get_id(); }
+    inline std::thread::native_handle_type nativeHandle() { return m_thread.native_handle(); }
+
+private:
+    void push(StrandTask* task);
+    StrandTask* pop();
+    bool hasPending() const;
+    void run();
+
+    alignas(utils::CACHE_LINE_SIZE) std::atomic<StrandTask*> m_head; // Written by the producers
+    alignas(utils::CACHE_LINE_SIZE) StrandTask* m_tail;              // The executor thread only
+    StrandTask m_stub;
+    StrandTask m_stopTask;
+    bool m_stopped;
+    alignas(utils::CACHE_LINE_SIZE) std::atomic<bool> m_idle;
+    std::thread m_thread;
+};
+
+} //! namespace __details
+
+/**
+ * @brief Gives the value its own thread: the callers never touch it, they send functors to the thread owning it.
+ * @details The executor applies the functors one at a time in the order of posting, so the value and its cache lines
+ * stay with one thread instead of following the callers from core to core.
+ * accessMutable()/accessImmutable() keep the MutableSync call shape and return a std::future with the result (or the
+ * exception) of the functor, the future may be dropped for a fire-and-forget call. post() is the cheaper
+ * fire-and-forget form without a future. The executor thread may be pinned to a core or a NUMA node with
+ * nativeHandle(), so the value stays in the memory local to it.
+ * @warning Waiting on the executor thread for a future of the same StrandSync never ends: a functor must not call
+ * get() on a future of its own StrandSync, nor getValue(). An exception escaping a posted functor terminates the
+ * program, use accessMutable() to get it back.
+ * @example
+ *      StrandSync<std::unordered_map<Key, Value>> map;
+ *
+ *      map.accessMutable([=](auto& map) { map[key] = value; });                    // Fire-and-forget
+ *      auto found = map.accessImmutable([=](const auto& map) { return map.contains(key); });
+ *      if (found.get()) { ... }
+ */
+template<typename T>
+class StrandSync final {
+public:
+    using ValueType = T;
+    using MutableValueRefType = ValueType&;
+    using ImmutableValueRefType = const ValueType&;
+
+    template<typename ... Args>
+    StrandSync(Args&& ... args):
+    m_value(std::forward<Args>(args) ...),
+    m_executor() {}
+
+    StrandSync(const StrandSync& ) = delete;
+    StrandSync& operator=(const StrandSync& ) = delete;
+
+    /**
+     * @brief Applies f to the value on the executor thread.
+     * @return The future result of f.
+     */
+    template<typename Func>
+    std::future<std::invoke_result_t<Func&, T&>> accessMutable(Func f) {
+        return submit<T&>(std::move(f));
+    }
+
+    template<typename Func>
+    std::future<std::invoke_result_t<Func&, const T&>> accessImmutable(Func f) {
+        static_assert(__details::IsCallableWithConstRef<T, Func>::value, "Func must accept const T&");
+        return submit<const T&>(std::move(f));
+    }
+
+    template<typename Func>
+    void post(Func f) {
+        enqueue([this, f = std::move(f)]() mutable { f(m_value); });
+    }
+
+    void setValue(T newValue) {
+        post([newValue = std::move(newValue)](T& value) mutable { value = std::move(newValue); });
+    }
+
+    T getValue() {
+        PANIC(m_executor.isCurrentThread());
+        return accessImmutable([](const T& value) { return value; }).get();
+    }
+
+    inline bool isExecutorThread() const { return m_executor.isCurrentThread(); }
+    inline std::thread::native_handle_type nativeHandle() { return m_executor.nativeHandle(); }
+
+private:
+    template<typename Func>
+    struct Task final : __details::StrandTask {
+        explicit Task(Func&& f): func(std::move(f)) {
+            run = [](__details::StrandTask* task) {
+                auto* self = static_cast<Task*>(task);
+                self->func();
+                delete self;
+            };
+        }
+
+        Func func;
+    };
+
+    template<typename Func>
+    inline void enqueue(Func&& f) { m_executor.post(new Task<std::decay_t<Func>>(std::forward<Func>(f))); }
+
+    template<typename Ref, typename Func>
+    std::future<std::invoke_result_t<Func&, Ref>> submit(Func f) {
+        using ResultType = std::invoke_result_t<Func&, Ref>;
+        static_assert(!std::is_reference_v<ResultType>, "The result is handed to the caller thread by value");
+
+        std::promise<ResultType> promise;
+        auto future = promise.get_future();
+        enqueue([this, f = std::move(f), promise = std::move(promise)]() mutable {
+            try {
+                if constexpr (std::is_void_v<ResultType>) {
+                    f(static_cast<Ref>(m_value));
+                    promise.set_value();
+                } else {
+                    promise.set_value(f(static_cast<Ref>(m_value)));
+                }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        });
+        return future;
+    }
+
+    // The executor is destroyed first, the tasks it still runs may use the value
+    T m_value;
+    __details::StrandExecutor m_executor;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_STRAND_SYNC_H
@@ -0,0 +1,181 @@
+#ifndef CONCURRENCY_STRIPED_SAFE_MUTEX_H
+#define CONCURRENCY_STRIPED_SAFE_MUTEX_H
+
+#include "include/concurrency/lock_order_graph.h"
+#include "include/concurrency/safe_mutex.h"
+#include "include/utils/cache_line.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ranges>
+#include <source_location>
+#include <utility>
+
+namespace atom::concurrency {
+
+/**
+ * @brief A fixed set of N SafeMutex stripes shared by any number of keys, for the tables which need a lock per
+ * bucket but can't afford a SafeMutex per bucket.
+ * @details A key is mapped to a stripe by its (mixed) hash, so the protected buckets don't store any lock and the
+ * contention falls with N. Each stripe is padded to its own cache line, the neighbour stripes don't share one.
+ * The stripes are ordered by their index: the constructor records the chain stripe(0) -> stripe(1) -> ... in the
+ * LockOrderGraph, so taking a lower stripe while a higher one of the same set is held closes a cycle right away
+ * (without waiting for another thread to take them in the opposite order) and is reported like any other lock
+ * order violation. The chain is recorded only if the checks or the LockSampler are on when the stripes are built.
+ * lockAll() takes the stripes of several keys in the ascending index order and each stripe once, even when keys
+ * share one, so it never violates the chain.
+ * @warning In checked builds the stripes held at once enter the LockStory, which holds at most
+ * LockStory::MAX_STORY_SIZE locks.
+ * @example
+ *      StripedSafeMutex<64> locks;
+ *
+ *      void transfer(Account from, Account to) {
+ *          auto guard = locks.lockAll(std::array{ from.id, to.id });
+ *          ...
+ *      }
+ */
+template<std::size_t N>
+requires (std::has_single_bit(N))
+class StripedSafeMutex final {
+    using WordType = std::uint64_t;
+    static constexpr std::size_t WORD_BITS = 64;
+    static constexpr std::size_t WORDS = (N + WORD_BITS - 1) / WORD_BITS;
+
+public:
+    static constexpr std::size_t STRIPES = N;
+
+    /**
+     * @brief RAII guard of the stripe of one key.
+     */
+    class Guard final {
+    public:
+        explicit Guard(LockStory& lockStory, SafeMutex& mutex): m_lockStory(lockStory), m_mutex(mutex) {
+            m_mutex.lock(m_lockStory);
+        }
+
+        ~Guard() { m_mutex.unlock(m_lockStory); }
+
+        Guard(const Guard& ) = delete;
+        Guard& operator=(const Guard& ) = delete;
+
+    private:
+        LockStory& m_lockStory;
+        SafeMutex& m_mutex;
+    };
+
+    /**
+     * @brief RAII guard of the stripes of several keys, they are taken in the ascending index order.
+     */
+    class MultiGuard final {
+    public:
+        explicit MultiGuard(LockStory& lockStory, StripedSafeMutex& stripes, const std::array<WordType, WORDS>& set):
+        m_lockStory(lockStory),
+        m_stripes(stripes),
+        m_set(set) {
+            forEach([this](const std::size_t index) { m_stripes.stripe(index).lock(m_lockStory); });
+        }
+
+        ~MultiGuard() {
+            forEach([this](const std::size_t index) { m_stripes.stripe(index).unlock(m_lockStory); });
+        }
+
+        MultiGuard(const MultiGuard& ) = delete;
+        MultiGuard& operator=(const MultiGuard& ) = delete;
+
+        inline bool holds(const std::size_t index) const { return (m_set[index / WORD_BITS] >> (index % WORD_BITS)) & 1; }
+
+    private:
+        template<typename Func>
+        void forEach(Func func) const {
+            for (std::size_t i = 0; i < WORDS; ++i) {
+                for (auto word = m_set[i]; word != 0; word &= word - 1) {
+                    func(i * WORD_BITS + static_cast<std::size_t>(std::countr_zero(word)));
+                }
+            }
+        }
+
+        LockStory& m_lockStory;
+        StripedSafeMutex& m_stripes;
+        std::array<WordType, WORDS> m_set;
+    };
+
+    explicit StripedSafeMutex(WaitPolicy policy = WaitPolicy::Fifo,
+        const std::source_location& location = std::source_location::current()):
+    m_stripes(MakeStripes(policy, location, std::make_index_sequence<N>{})) {
+        // Nobody checks the order while the checks and the sampler are off, the stripes stay out of the graph then
+        if (RuntimeChecks::enabled() || LockSampler::interval() != 0) {
+            auto& graph = LockOrderGraph::instance();
+            for (std::size_t i = 1; i < N; ++i) {
+                graph.addEdge(stripe(i - 1).id(), stripe(i).id());
+            }
+        }
+    }
+
+    StripedSafeMutex(const StripedSafeMutex& ) = delete;
+    StripedSafeMutex& operator=(const StripedSafeMutex& ) = delete;
+
+    /**
+     * @brief Maps a hash to a stripe index. std::hash of an integer is the integer itself, so the hash is mixed
+     * (Fibonacci hashing) and the index is taken from its high bits, sequential keys go to different stripes.
+     */
+    static inline std::size_t StripeOf(const std::size_t hash) {
+        if constexpr (N == 1) {
+            return 0;
+        } else {
+            constexpr auto shift = 64 - std::countr_zero(N);
+            return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> shift);
+        }
+    }
+
+    template<typename Key, typename Hash = std::hash<Key>>
+    static inline std::size_t StripeFor(const Key& key, const Hash& hash = Hash{}) { return StripeOf(hash(key)); }
+
+    inline SafeMutex& stripe(const std::size_t index) { return m_stripes[index].mutex; }
+
+    template<typename Key>
+    inline SafeMutex& mutexFor(const Key& key) { return stripe(StripeFor(key)); }
+
+    template<typename Key>
+    [[nodiscard]] inline Guard lockFor(LockStory& lockStory, const Key& key) { return Guard{ lockStory, mutexFor(key) }; }
+
+    template<typename Key>
+    [[nodiscard]] inline Guard lockFor(const Key& key) { return lockFor(LockStory::current(), key); }
+
+    /**
+     * @brief Locks the stripes of all keys, the keys which share a stripe take it once.
+     */
+    template<std::ranges::input_range Keys>
+    [[nodiscard]] MultiGuard lockAll(LockStory& lockStory, const Keys& keys) {
+        std::array<WordType, WORDS> set{};
+        for (const auto& key : keys) {
+            const auto index = StripeFor(key);
+            set[index / WORD_BITS] |= WordType{ 1 } << (index % WORD_BITS);
+        }
+        return MultiGuard{ lockStory, *this, set };
+    }
+
+    template<std::ranges::input_range Keys>
+    [[nodiscard]] inline MultiGuard lockAll(const Keys& keys) { return lockAll(LockStory::current(), keys); }
+
+private:
+    struct alignas(utils::CACHE_LINE_SIZE) Stripe final {
+        explicit Stripe(const WaitPolicy policy, const std::source_location& location): mutex(policy, location) {}
+
+        SafeMutex mutex;
+    };
+
+    template<std::size_t ... Indexes>
+    static std::array<Stripe, N> MakeStripes(const WaitPolicy policy, const std::source_location& location,
+        std::index_sequence<Indexes ...>) {
+        return { ((void)Indexes, Stripe{ policy, location }) ... };
+    }
+
+    std::array<Stripe, N> m_stripes;
+};
+
+} //! namespace atom::concurrency
+
+#endif //! CONCURRENCY_STRIPED_SAFE_MUTEX_H
@@ -11,7 +11,9 @@
 #include <cstdint>
 #include <cassert>
 
+#include "include/concurrency/runtime_checks.h"
 #include "include/utils/assertion.h"
+#include "include/utils/cache_line.h"
 
 namespace atom::concurrency {
 
@@ -29,8 +31,8 @@ struct IsCallableWithConstRef<T*, Func, std::void_t<decltype(std::declval<Func>(
 
 } //! namespace __details
 
-#ifdef NDEBUG
-    
+#ifndef ATOM_CHECKED_BUILD
+
 template<typename T, typename C>
 class MutableSync;
 
@@ -87,7 +89,7 @@ public:
     inline void accessMutable(Func f) { f(m_value); }
 
     template<typename Func>
-    inline void accessImmutable(Func f) { f(m_value); }
+    inline void accessImmutable(Func f) const { f(m_value); }
 
     inline void setValue(const T& newValue) { m_value = newValue; }
     inline void setValue(T&& newValue) { m_value = std::move(newValue); }
@@ -181,11 +183,27 @@ public:
     MutableSync(Args&& ... args);
     ~MutableSync() = default;
 
+    /**
+     * @brief Without the RuntimeChecks the access is a call of f, the checked access is out of the line.
+     */
     template<typename Func>
-    void accessMutable(Func f);
+    inline void accessMutable(Func f) {
+        if (RuntimeChecks::enabled()) [[unlikely]] {
+            checkedAccessMutable(std::move(f));
+            return;
+        }
+        f(m_value);
+    }
 
     template<typename Func>
-    void accessImmutable(Func f);
+    inline void accessImmutable(Func f) const {
+        static_assert(__details::IsCallableWithConstRef<T, Func>::value, "Func must accept const T&");
+        if (RuntimeChecks::enabled()) [[unlikely]] {
+            checkedAccessImmutable(std::move(f));
+            return;
+        }
+        f(m_value);
+    }
 
     void setValue(const T& newValue);
     void setValue(T&& newValue);
@@ -194,12 +212,29 @@ public:
     T getValue() const;
 
 private:
-    TimeStampType genTimestamp(std::atomic<TimeStampType>& counter) const;
-    TimeStampType getCurrentTimestamp(const std::atomic<TimeStampType>& counter) const;
+    template<typename Func>
+    void checkedAccessMutable(Func f);
 
-    mutable std::atomic<TimeStampType> m_writers;
-    mutable std::atomic<TimeStampType> m_readers;
-    std::atomic<std::uint64_t> m_refCount;
+    template<typename Func>
+    void checkedAccessImmutable(Func f) const;
+
+    // The writer stamp lives in the high half of the word and the reader stamp in the low one, so an access
+    // stamps both with a single RMW and reads them back with a single load
+    static_assert(sizeof(TimeStampType) <= sizeof(std::uint32_t), "TimeStampType must fit into a half of the stamp word");
+    using StampWordType = std::conditional_t<sizeof(TimeStampType) <= sizeof(std::uint16_t), std::uint32_t, std::uint64_t>;
+
+    static constexpr auto STAMP_BITS = sizeof(StampWordType) * 4;
+    static constexpr auto READER_STAMP = StampWordType{ 1 };
+    static constexpr auto WRITER_STAMP = StampWordType{ 1 } << STAMP_BITS;
+
+    static inline StampWordType WriterBits(const StampWordType stamps) { return stamps >> STAMP_BITS; }
+    static inline StampWordType ReaderBits(const StampWordType stamps) { return stamps & (WRITER_STAMP - 1); }
+    static inline TimeStampType WriterOf(const StampWordType stamps) { return static_cast<TimeStampType>(WriterBits(stamps)); }
+    static inline TimeStampType ReaderOf(const StampWordType stamps) { return static_cast<TimeStampType>(ReaderBits(stamps)); }
+
+    StampWordType genStamps(StampWordType increment) const;
+
+    mutable std::atomic<StampWordType> m_stamps;
     T m_value;
 };
 
@@ -235,40 +270,36 @@ private:
 template<typename T, typename C>
 template<typename ... Args>
 MutableSync<T, C>::MutableSync(Args&& ... args):
-m_writers(0),
-m_readers(0),
+m_stamps(0),
 m_value(std::forward<Args>(args) ...)
 {}
 
 template<typename T, typename C>
 template<typename Func>
-void MutableSync<T, C>::accessImmutable(Func f)
+void MutableSync<T, C>::checkedAccessImmutable(Func f) const
 {
-    static_assert(__details::IsCallableWithConstRef<T, Func>::value, "Func must accept const T&");
-    const auto oldW = genTimestamp(m_writers);
+    const auto oldStamps = genStamps(WRITER_STAMP);
 
     f(m_value);
 
-    const auto currentW = getCurrentTimestamp(m_writers);
+    const auto currentStamps = m_stamps.load();
 
-    PANIC(currentW == INVALID_TIME_STAMP);
-    PANIC(oldW != currentW);
+    PANIC(WriterOf(currentStamps) == INVALID_TIME_STAMP);
+    PANIC(WriterOf(oldStamps) != WriterOf(currentStamps));
 }
 
 template<typename T, typename C>
 template<typename Func>
-void MutableSync<T, C>::accessMutable(Func f)
+void MutableSync<T, C>::checkedAccessMutable(Func f)
 {
-    const auto oldW = genTimestamp(m_writers);
-    const auto oldR = genTimestamp(m_readers);
+    const auto oldStamps = genStamps(WRITER_STAMP | READER_STAMP);
 
     f(m_value);
 
-    const auto currentW = getCurrentTimestamp(m_writers);
-    const auto currentR = getCurrentTimestamp(m_readers);
+    const auto currentStamps = m_stamps.load();
 
-    PANIC(currentW == INVALID_TIME_STAMP);
-    PANIC(oldW != currentW && oldR == currentR);
+    PANIC(WriterOf(currentStamps) == INVALID_TIME_STAMP);
+    PANIC(WriterOf(oldStamps) != WriterOf(currentStamps) && ReaderOf(oldStamps) == ReaderOf(currentStamps));
 }
 
 template<typename T, typename C>
@@ -310,27 +341,27 @@ T MutableSync<T, C>::getValue() const
 }
 
 template<typename T, typename C>
-typename MutableSync<T, C>::TimeStampType
-MutableSync<T, C>::genTimestamp(std::atomic<TimeStampType>& counter) const
+typename MutableSync<T, C>::StampWordType
+MutableSync<T, C>::genStamps(const StampWordType increment) const
 {
-    TimeStampType timestamp = 0;
+    const auto limit = static_cast<StampWordType>(TIME_STAMP_LIMIT);
     while (true) {
-        timestamp = counter.fetch_add(1) + 1;
-        if (timestamp < TIME_STAMP_LIMIT) {
-            break;
+        const auto stamps = m_stamps.fetch_add(increment) + increment;
+        if (WriterBits(stamps) < limit && ReaderBits(stamps) < limit) {
+            return stamps;
         }
 
-        counter.store(0);
+        // The stamp which has reached the limit starts over from 0, the other one keeps its value
+        auto expected = stamps;
+        auto restarted = stamps;
+        if (WriterBits(stamps) >= limit) {
+            restarted &= WRITER_STAMP - 1;
+        }
+        if (ReaderBits(stamps) >= limit) {
+            restarted &= ~(WRITER_STAMP - 1);
+        }
+        m_stamps.compare_exchange_strong(expected, restarted);
     }
-
-    return timestamp;
-}
-
-template<typename T, typename C>
-typename MutableSync<T, C>::TimeStampType
-MutableSync<T, C>::getCurrentTimestamp(const std::atomic<TimeStampType>& counter) const
-{
-    return counter.load();
 }
 
 /* end class MutableSync<T> */
@@ -373,7 +404,36 @@ T Sync<T>::getValue() const
 
 /* end class Sync<T> */
 
-#endif
+#endif //! ifndef ATOM_CHECKED_BUILD
+
+/**
+ * @brief MutableSync padded to its own cache line(s), so neighbouring elements of an array don't false-share the
+ * stamps and the values updated by different threads.
+ */
+template<typename T, typename C = DefaultSyncConfig>
+class alignas(utils::CACHE_LINE_SIZE) CacheAlignedMutableSync final {
+public:
+    using SyncType = MutableSync<T, C>;
+    using ValueType = typename SyncType::ValueType;
+
+    template<typename ... Args>
+    CacheAlignedMutableSync(Args&& ... args): m_sync(std::forward<Args>(args) ...) {}
+
+    template<typename Func>
+    inline void accessMutable(Func f) { m_sync.accessMutable(std::move(f)); }
+
+    template<typename Func>
+    inline void accessImmutable(Func f) const { m_sync.accessImmutable(std::move(f)); }
+
+    inline void setValue(const T& newValue) { m_sync.setValue(newValue); }
+    inline void setValue(T&& newValue) { m_sync.setValue(std::move(newValue)); }
+
+    inline T getValue() { return m_sync.getValue(); }
+    inline T getValue() const { return m_sync.getValue(); }
+
+private:
+    SyncType m_sync;
+};
 
 } //! namespace atom::concurrency::mem
 
@@ -0,0 +1,17 @@
+#ifndef CACHE_LINE_H
+#define CACHE_LINE_H
+
+#include <cstddef>
+
+namespace atom::utils {
+
+/**
+ * @brief Size of the destructive interference range used to pad hot atomics.
+ * @details std::hardware_destructive_interference_size is not stable across compiler flags (gcc warns about using
+ * it in headers), so the common x86-64/aarch64 value is fixed here.
+ */
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+} //! namespace atom::utils
+
+#endif //! CACHE_LINE_H
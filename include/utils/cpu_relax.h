@@ -0,0 +1,22 @@
+#ifndef CPU_RELAX_H
+#define CPU_RELAX_H
+
+namespace atom::utils {
+
+/**
+ * @brief Spin-wait hint: tells the core that we are in a busy-wait loop (pause on x86, yield on arm).
+ * @details It saves power, frees the pipeline for the sibling hyper-thread and avoids the memory order
+ * mis-speculation penalty when the awaited cache line finally changes.
+ */
+inline void CpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+} //! namespace atom::utils
+
+#endif //! CPU_RELAX_H
@@ -0,0 +1,168 @@
+#include "include/concurrency/async_safe_mutex.h"
+
+#include "include/utils/assertion.h"
+
+#include <cassert>
+
+namespace atom::concurrency {
+
+namespace {
+
+// The waiters handed the mutex by the unlocks nested in a resumption on this thread, the outermost unlock resumes them
+struct ResumeQueue final {
+    AsyncSafeMutex::LockAwaiter* head = nullptr;
+    AsyncSafeMutex::LockAwaiter* tail = nullptr;
+    bool resuming = false;
+};
+
+thread_local ResumeQueue resumeQueue;
+
+} //! namespace
+
+bool AsyncSafeMutex::LockAwaiter::await_ready()
+{
+    m_mutex.onLocking(m_lockStory);
+    return m_mutex.tryAcquire();
+}
+
+bool AsyncSafeMutex::LockAwaiter::await_suspend(const std::coroutine_handle<> handle)
+{
+    m_handle = handle;
+    return m_mutex.enqueue(*this);
+}
+
+void AsyncSafeMutex::LockAwaiter::await_resume()
+{
+    m_mutex.m_owner = &m_lockStory;
+}
+
+AsyncSafeMutex::AsyncSafeMutex():
+m_id(__details::GenerateLockId()),
+m_state(UNLOCKED_STATE),
+m_waiters(nullptr),
+m_owner(nullptr)
+{}
+
+AsyncSafeMutex::~AsyncSafeMutex()
+{
+    assert(m_state.load(std::memory_order_relaxed) == UNLOCKED_STATE);
+    __details::ReleaseLockId(m_id);
+}
+
+LockResultType AsyncSafeMutex::tryLock(LockStory& lockStory)
+{
+#ifdef ATOM_CHECKED_BUILD
+    const auto checked = RuntimeChecks::enabled();
+    if (checked && lockStory.find(m_id) != nullptr) [[unlikely]] {
+        return LockResultType::onError(LockError::Deadlock);
+    }
+#endif
+
+    if (!tryAcquire()) {
+        return LockResultType::onError(LockError::WouldBlock);
+    }
+
+#ifdef ATOM_CHECKED_BUILD
+    if (checked) [[unlikely]] {
+        lockStory.add(m_id, LockMode::Exclusive);
+    }
+#endif
+    m_owner = &lockStory;
+    return LockResultType::onOk();
+}
+
+void AsyncSafeMutex::unlock([[maybe_unused]] LockStory& lockStory)
+{
+    assert(m_owner == &lockStory);
+#ifdef ATOM_CHECKED_BUILD
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        lockStory.remove(m_id);
+    }
+#endif
+    m_owner = nullptr;
+
+    auto* head = m_waiters;
+    if (!head) {
+        auto state = LOCKED_STATE;
+        if (m_state.compare_exchange_strong(state, UNLOCKED_STATE, std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+
+        // Take all newly queued waiters at once and reverse them into the arrival order
+        state = m_state.exchange(LOCKED_STATE, std::memory_order_acquire);
+        auto* awaiter = reinterpret_cast<LockAwaiter*>(state);
+        do {
+            auto* next = awaiter->m_next;
+            awaiter->m_next = head;
+            head = awaiter;
+            awaiter = next;
+        } while (awaiter);
+    }
+
+    // The mutex stays locked and passes to the first waiter
+    m_waiters = head->m_next;
+    resume(*head);
+}
+
+void AsyncSafeMutex::resume(LockAwaiter& awaiter)
+{
+    auto& queue = resumeQueue;
+    if (queue.resuming) {
+        awaiter.m_next = nullptr;
+        (queue.tail ? queue.tail->m_next : queue.head) = &awaiter;
+        queue.tail = &awaiter;
+        return;
+    }
+
+    // A resumed awaiter may be gone once its coroutine suspends or finishes, only the queued ones are read after it
+    queue.resuming = true;
+    for (auto handle = awaiter.m_handle; handle;) {
+        handle.resume();
+        handle = nullptr;
+        if (auto* next = queue.head) {
+            queue.head = next->m_next;
+            if (!queue.head) {
+                queue.tail = nullptr;
+            }
+            handle = next->m_handle;
+        }
+    }
+    queue.resuming = false;
+}
+
+bool AsyncSafeMutex::tryAcquire()
+{
+    auto expected = UNLOCKED_STATE;
+    return m_state.compare_exchange_strong(expected, LOCKED_STATE, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+bool AsyncSafeMutex::enqueue(LockAwaiter& awaiter)
+{
+    auto state = m_state.load(std::memory_order_acquire);
+    while (true) {
+        if (state == UNLOCKED_STATE) {
+            if (m_state.compare_exchange_weak(state, LOCKED_STATE, std::memory_order_acquire, std::memory_order_acquire)) {
+                return false;
+            }
+        } else {
+            awaiter.m_next = reinterpret_cast<LockAwaiter*>(state);
+            if (m_state.compare_exchange_weak(state, reinterpret_cast<std::uintptr_t>(&awaiter), std::memory_order_release,
+                std::memory_order_acquire)) {
+                return true;
+            }
+        }
+    }
+}
+
+void AsyncSafeMutex::onLocking([[maybe_unused]] LockStory& lockStory)
+{
+#ifdef ATOM_CHECKED_BUILD
+    // The mutex enters the story before the coroutine suspends, as SafeMutex does before it blocks
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        PANIC(!lockStory.recordLockOrder(m_id));
+        lockStory.add(m_id, LockMode::Exclusive);
+    }
+#endif
+}
+
+} //! namespace atom::concurrency
@@ -0,0 +1,245 @@
+#include "include/concurrency/epoch_domain.h"
+
+#include "include/utils/assertion.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace atom::concurrency {
+
+namespace {
+
+using EpochRecord = __details::EpochRecord;
+
+// Ids of the live domains, a thread gives its records back at exit only to the domains which are still alive
+struct DomainRegistry final {
+    std::mutex mutex;
+    std::vector<std::uint64_t> liveDomains;
+    std::uint64_t nextId = 1;
+};
+
+DomainRegistry& GetRegistry()
+{
+    static DomainRegistry registry;
+    return registry;
+}
+
+// The records taken by the thread, the entry of the domain used last goes first
+class ThreadRecords final {
+public:
+    struct Entry final {
+        std::uint64_t domainId;
+        EpochRecord* record;
+    };
+
+    explicit ThreadRecords(): m_entries() {}
+
+    ~ThreadRecords() {
+        if (m_entries.empty()) {
+            return;
+        }
+
+        auto& registry = GetRegistry();
+        std::lock_guard lock{ registry.mutex };
+        for (const auto& entry : m_entries) {
+            const auto& live = registry.liveDomains;
+            if (std::find(live.cbegin(), live.cend(), entry.domainId) != live.cend()) {
+                entry.record->epoch.store(EpochRecord::QUIESCENT);
+                entry.record->nesting = 0;
+                entry.record->inUse.store(false, std::memory_order_release);
+            }
+        }
+    }
+
+    ThreadRecords(const ThreadRecords& ) = delete;
+    ThreadRecords& operator=(const ThreadRecords& ) = delete;
+
+    EpochRecord* find(const std::uint64_t domainId) {
+        for (auto& entry : m_entries) {
+            if (entry.domainId == domainId) {
+                std::swap(entry, m_entries.front());
+                return m_entries.front().record;
+            }
+        }
+        return nullptr;
+    }
+
+    void add(const std::uint64_t domainId, EpochRecord* record) { m_entries.push_back(Entry{ domainId, record }); }
+
+private:
+    std::vector<Entry> m_entries;
+};
+
+thread_local ThreadRecords threadRecords;
+
+} //! namespace
+
+EpochDomain::Guard::Guard(EpochDomain& domain):
+m_record(domain.threadRecord())
+{
+    if (m_record.nesting++ == 0) {
+        domain.enter(m_record);
+    }
+}
+
+EpochDomain::Guard::~Guard()
+{
+    if (--m_record.nesting == 0) {
+        m_record.epoch.store(EpochRecord::QUIESCENT, std::memory_order_release);
+    }
+}
+
+EpochDomain& EpochDomain::instance()
+{
+    static EpochDomain domain;
+    return domain;
+}
+
+EpochDomain::EpochDomain():
+m_id(0),
+m_epoch(1),
+m_records(nullptr),
+m_retiredMutex(),
+m_retired()
+{
+    auto& registry = GetRegistry();
+    std::lock_guard lock{ registry.mutex };
+    m_id = registry.nextId++;
+    registry.liveDomains.push_back(m_id);
+}
+
+EpochDomain::~EpochDomain()
+{
+    {
+        auto& registry = GetRegistry();
+        std::lock_guard lock{ registry.mutex };
+        auto& live = registry.liveDomains;
+        live.erase(std::find(live.begin(), live.end(), m_id));
+    }
+
+    for (const auto& retired : m_retired) {
+        retired.deleter(retired.object);
+    }
+
+    for (auto* record = m_records.load(); record;) {
+        auto* next = record->next;
+        delete record;
+        record = next;
+    }
+}
+
+void EpochDomain::retire(void* const object, const DeleterType deleter)
+{
+    std::size_t retiredCount = 0;
+    {
+        // The object is unlinked already, so the readers which can still see it are in this epoch or an older one
+        std::lock_guard lock{ m_retiredMutex };
+        m_retired.push_back(Retired{ m_epoch.load(), object, deleter });
+        retiredCount = m_retired.size();
+    }
+
+    if (retiredCount % RECLAIM_THRESHOLD == 0) {
+        reclaim();
+    }
+}
+
+std::size_t EpochDomain::reclaim()
+{
+    tryAdvance();
+
+    std::vector<Retired> ready;
+    {
+        const auto epoch = m_epoch.load();
+        std::lock_guard lock{ m_retiredMutex };
+        const auto middle = std::partition(m_retired.begin(), m_retired.end(), [epoch](const Retired& retired) {
+            return retired.epoch + 2 > epoch;
+        });
+        ready.assign(middle, m_retired.end());
+        m_retired.erase(middle, m_retired.end());
+    }
+
+    // The deleters run without the lock, they may retire more objects
+    for (const auto& retired : ready) {
+        retired.deleter(retired.object);
+    }
+    return ready.size();
+}
+
+void EpochDomain::synchronize()
+{
+    // A thread which has never entered the domain has no record, there is no reason to take one for it here
+    const auto* record = threadRecords.find(m_id);
+    PANIC(record && record->nesting > 0);
+
+    const auto target = m_epoch.load() + 2;
+    while (m_epoch.load() < target) {
+        if (!tryAdvance()) {
+            std::this_thread::yield();
+        }
+    }
+    reclaim();
+}
+
+std::size_t EpochDomain::retiredCount() const
+{
+    std::lock_guard lock{ m_retiredMutex };
+    return m_retired.size();
+}
+
+EpochRecord& EpochDomain::threadRecord()
+{
+    if (auto* record = threadRecords.find(m_id)) {
+        return *record;
+    }
+
+    // Reuse the record of an exited thread, or publish a new one
+    auto* record = m_records.load();
+    for (; record; record = record->next) {
+        auto inUse = false;
+        if (!record->inUse.load(std::memory_order_relaxed)
+            && record->inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    if (!record) {
+        record = new EpochRecord{};
+        record->inUse.store(true, std::memory_order_relaxed);
+        record->next = m_records.load();
+        while (!m_records.compare_exchange_weak(record->next, record)) {}
+    }
+
+    threadRecords.add(m_id, record);
+    return *record;
+}
+
+void EpochDomain::enter(EpochRecord& record) const
+{
+    // The announcement must be visible before the reader loads any shared pointer, and the epoch must not have
+    // moved on meanwhile: a reclaimer which didn't see the announcement could have advanced past it
+    auto epoch = m_epoch.load();
+    while (true) {
+        record.epoch.store(epoch);
+        const auto current = m_epoch.load();
+        if (current == epoch) {
+            return;
+        }
+        epoch = current;
+    }
+}
+
+bool EpochDomain::tryAdvance()
+{
+    auto epoch = m_epoch.load();
+    for (const auto* record = m_records.load(); record; record = record->next) {
+        const auto announced = record->epoch.load();
+        if (announced != EpochRecord::QUIESCENT && announced != epoch) {
+            return false;
+        }
+    }
+
+    m_epoch.compare_exchange_strong(epoch, epoch + 1);
+    return true;
+}
+
+} //! namespace atom::concurrency
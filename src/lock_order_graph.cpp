@@ -0,0 +1,201 @@
+#include "include/concurrency/lock_order_graph.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace atom::concurrency {
+
+namespace {
+
+constexpr std::size_t WORD_BITS = 64;
+
+inline bool TestBit(const std::vector<std::uint64_t>& bits, const LockOrderGraph::NodeType node)
+{
+    return bits[node / WORD_BITS] & (std::uint64_t{ 1 } << (node % WORD_BITS));
+}
+
+inline void SetBit(std::vector<std::uint64_t>& bits, const LockOrderGraph::NodeType node)
+{
+    bits[node / WORD_BITS] |= std::uint64_t{ 1 } << (node % WORD_BITS);
+}
+
+inline void ClearBit(std::vector<std::uint64_t>& bits, const LockOrderGraph::NodeType node)
+{
+    bits[node / WORD_BITS] &= ~(std::uint64_t{ 1 } << (node % WORD_BITS));
+}
+
+} //! namespace
+
+LockOrderGraph& LockOrderGraph::instance()
+{
+    static LockOrderGraph graph;
+    return graph;
+}
+
+LockOrderGraph::LockOrderGraph():
+m_nodes(),
+m_visited(),
+m_targets(),
+m_reached(),
+m_size(0),
+m_mutex()
+{}
+
+void LockOrderGraph::removeNode(const NodeType node)
+{
+    // The common case: the lock has never been ordered against another one
+    if (m_size.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+
+    {
+        std::shared_lock lock{ m_mutex };
+        if (!hasNode(node)) {
+            return;
+        }
+    }
+
+    std::unique_lock lock{ m_mutex };
+    if (!hasNode(node)) {
+        return;
+    }
+
+    const auto removed = std::move(m_nodes[node]);
+    m_nodes[node] = Node{};
+    for (const auto next : removed.successors) {
+        unlink(next, node, &Node::predecessors);
+    }
+    for (const auto prev : removed.predecessors) {
+        unlink(prev, node, &Node::successors);
+    }
+    m_size.fetch_sub(1, std::memory_order_release);
+}
+
+bool LockOrderGraph::addEdge(const NodeType from, const NodeType to)
+{
+    return addEdges({ &from, 1 }, to);
+}
+
+bool LockOrderGraph::addEdges(const std::span<const NodeType> from, const NodeType to)
+{
+    {
+        std::shared_lock lock{ m_mutex };
+        if (hasEdgesImpl(from, to)) {
+            return true;
+        }
+    }
+
+    std::unique_lock lock{ m_mutex };
+    // Another thread could record the same edges while we were waiting for the exclusive lock
+    if (hasEdgesImpl(from, to)) {
+        return true;
+    }
+
+    reserve(std::max(to, from.empty() ? to : std::ranges::max(from)));
+    // A cycle of any length through the new edges exists iff `to` is one of the sources or already reaches one
+    if (reachesAny(to, from)) {
+        return false;
+    }
+
+    for (const auto node : from) {
+        link(node, to, &Node::successors);
+        link(to, node, &Node::predecessors);
+    }
+    return true;
+}
+
+bool LockOrderGraph::hasEdge(const NodeType from, const NodeType to) const
+{
+    std::shared_lock lock{ m_mutex };
+    return hasEdgesImpl({ &from, 1 }, to);
+}
+
+void LockOrderGraph::clear()
+{
+    std::unique_lock lock{ m_mutex };
+    m_nodes.clear();
+    m_visited.clear();
+    m_targets.clear();
+    m_size.store(0, std::memory_order_release);
+}
+
+void LockOrderGraph::reserve(const NodeType node)
+{
+    if (node < m_nodes.size()) {
+        return;
+    }
+
+    m_nodes.resize(static_cast<std::size_t>(node) + 1);
+    const auto words = (m_nodes.size() + WORD_BITS - 1) / WORD_BITS;
+    m_visited.resize(words);
+    m_targets.resize(words);
+}
+
+bool LockOrderGraph::hasEdgesImpl(const std::span<const NodeType> from, const NodeType to) const
+{
+    return std::ranges::all_of(from, [this, to](const NodeType node) {
+        return node < m_nodes.size() && std::ranges::binary_search(m_nodes[node].successors, to);
+    });
+}
+
+bool LockOrderGraph::reachesAny(const NodeType from, const std::span<const NodeType> targets)
+{
+    for (const auto target : targets) {
+        SetBit(m_targets, target);
+    }
+
+    // The reached nodes are visited in the order of discovery, the same list tells which bits to clear afterwards
+    m_reached.assign(1, from);
+    SetBit(m_visited, from);
+    auto found = false;
+    for (std::size_t i = 0; i < m_reached.size(); ++i) {
+        const auto node = m_reached[i];
+        if (TestBit(m_targets, node)) {
+            found = true;
+            break;
+        }
+        for (const auto next : m_nodes[node].successors) {
+            if (!TestBit(m_visited, next)) {
+                SetBit(m_visited, next);
+                m_reached.push_back(next);
+            }
+        }
+    }
+
+    for (const auto node : m_reached) {
+        ClearBit(m_visited, node);
+    }
+    for (const auto target : targets) {
+        ClearBit(m_targets, target);
+    }
+    return found;
+}
+
+void LockOrderGraph::link(const NodeType node, const NodeType neighbour, std::vector<NodeType> Node::* const edges)
+{
+    auto& entry = m_nodes[node];
+    if (entry.isolated()) {
+        m_size.fetch_add(1, std::memory_order_release);
+    }
+
+    auto& list = entry.*edges;
+    const auto it = std::ranges::lower_bound(list, neighbour);
+    if (it == list.end() || *it != neighbour) {
+        list.insert(it, neighbour);
+    }
+}
+
+void LockOrderGraph::unlink(const NodeType node, const NodeType neighbour, std::vector<NodeType> Node::* const edges)
+{
+    auto& entry = m_nodes[node];
+    auto& list = entry.*edges;
+    list.erase(std::ranges::lower_bound(list, neighbour));
+
+    // A node without edges leaves the graph
+    if (entry.isolated()) {
+        entry = Node{};
+        m_size.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+} //! namespace atom::concurrency
@@ -0,0 +1,205 @@
+#include "include/concurrency/lock_profiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+
+namespace {
+
+using namespace atom::concurrency;
+
+std::uint64_t ToNanoseconds(const LockProfile::ClockType::duration duration)
+{
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    return ns > 0 ? static_cast<std::uint64_t>(ns) : 0;
+}
+
+// Upper bound of the bucket which contains the requested percentile
+std::chrono::nanoseconds Percentile(const LockProfileSnapshot::HistogramType& histogram, const double percentile)
+{
+    std::uint64_t total = 0;
+    for (const auto count : histogram) {
+        total += count;
+    }
+
+    if (total == 0) {
+        return std::chrono::nanoseconds{ 0 };
+    }
+
+    const auto rank = static_cast<std::uint64_t>(static_cast<double>(total) * percentile);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < histogram.size(); ++i) {
+        seen += histogram[i];
+        if (seen > rank) {
+            return std::chrono::nanoseconds{ std::uint64_t{ 1 } << i };
+        }
+    }
+
+    return std::chrono::nanoseconds{ std::uint64_t{ 1 } << (histogram.size() - 1) };
+}
+
+} //! namespace
+
+namespace atom::concurrency {
+
+LockProfile::LockProfile(const std::string_view name):
+m_name(name),
+m_acquiredAt(),
+m_shards()
+{
+    LockProfiler::instance().add(*this);
+}
+
+LockProfile::~LockProfile()
+{
+    LockProfiler::instance().remove(*this);
+}
+
+void LockProfile::onAcquire(const bool contended, const ClockType::duration waitTime)
+{
+    auto& shard = m_shards[CurrentShard()];
+    shard.acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (contended) {
+        shard.contended.fetch_add(1, std::memory_order_relaxed);
+        shard.totalWaitNs.fetch_add(ToNanoseconds(waitTime), std::memory_order_relaxed);
+    }
+    shard.waitHistogram[BucketOf(waitTime)].fetch_add(1, std::memory_order_relaxed);
+
+    m_acquiredAt = ClockType::now();
+}
+
+void LockProfile::onRelease()
+{
+    const auto holdTime = ClockType::now() - m_acquiredAt;
+
+    auto& shard = m_shards[CurrentShard()];
+    shard.totalHoldNs.fetch_add(ToNanoseconds(holdTime), std::memory_order_relaxed);
+    shard.holdHistogram[BucketOf(holdTime)].fetch_add(1, std::memory_order_relaxed);
+}
+
+LockProfileSnapshot LockProfile::snapshot() const
+{
+    LockProfileSnapshot snapshot{ m_name, 0, 0, std::chrono::nanoseconds{ 0 }, std::chrono::nanoseconds{ 0 }, {}, {} };
+    for (const auto& shard : m_shards) {
+        snapshot.acquisitions += shard.acquisitions.load(std::memory_order_relaxed);
+        snapshot.contended += shard.contended.load(std::memory_order_relaxed);
+        snapshot.totalWait += std::chrono::nanoseconds{ shard.totalWaitNs.load(std::memory_order_relaxed) };
+        snapshot.totalHold += std::chrono::nanoseconds{ shard.totalHoldNs.load(std::memory_order_relaxed) };
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            snapshot.waitHistogram[i] += shard.waitHistogram[i].load(std::memory_order_relaxed);
+            snapshot.holdHistogram[i] += shard.holdHistogram[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    return snapshot;
+}
+
+void LockProfile::reset()
+{
+    for (auto& shard : m_shards) {
+        shard.acquisitions.store(0, std::memory_order_relaxed);
+        shard.contended.store(0, std::memory_order_relaxed);
+        shard.totalWaitNs.store(0, std::memory_order_relaxed);
+        shard.totalHoldNs.store(0, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            shard.waitHistogram[i].store(0, std::memory_order_relaxed);
+            shard.holdHistogram[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::size_t LockProfile::BucketOf(const ClockType::duration duration)
+{
+    const auto bucket = static_cast<std::size_t>(std::bit_width(ToNanoseconds(duration)));
+    return std::min(bucket, BUCKETS - 1);
+}
+
+std::string LockProfile::NameOf(const std::string_view name)
+{
+    return std::string{ name };
+}
+
+std::string LockProfile::NameOf(const std::source_location& location)
+{
+    return std::string{ location.file_name() } + ":" + std::to_string(location.line());
+}
+
+std::size_t LockProfile::CurrentShard()
+{
+    static std::atomic<std::size_t> nextShard{ 0 };
+    thread_local const std::size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return shard;
+}
+
+LockProfiler& LockProfiler::instance()
+{
+    static LockProfiler profiler;
+    return profiler;
+}
+
+LockProfiler::LockProfiler():
+m_profiles(),
+m_mutex()
+{}
+
+void LockProfiler::add(LockProfile& profile)
+{
+    std::lock_guard lock{ m_mutex };
+    m_profiles.insert(&profile);
+}
+
+void LockProfiler::remove(LockProfile& profile)
+{
+    std::lock_guard lock{ m_mutex };
+    m_profiles.erase(&profile);
+}
+
+std::vector<LockProfileSnapshot> LockProfiler::snapshot() const
+{
+    std::vector<LockProfileSnapshot> snapshots;
+    {
+        std::lock_guard lock{ m_mutex };
+        snapshots.reserve(m_profiles.size());
+        for (const auto* profile : m_profiles) {
+            snapshots.push_back(profile->snapshot());
+        }
+    }
+
+    std::sort(snapshots.begin(), snapshots.end(), [](const LockProfileSnapshot& lhs, const LockProfileSnapshot& rhs) {
+        return lhs.totalWait != rhs.totalWait ? lhs.totalWait > rhs.totalWait : lhs.contended > rhs.contended;
+    });
+    return snapshots;
+}
+
+void LockProfiler::report(std::ostream& os) const
+{
+    os << std::left << std::setw(48) << "lock"
+        << std::right << std::setw(14) << "acquisitions"
+        << std::setw(12) << "contended"
+        << std::setw(16) << "total wait ns"
+        << std::setw(14) << "p50 wait ns"
+        << std::setw(14) << "p99 wait ns"
+        << std::setw(14) << "p50 hold ns"
+        << std::setw(14) << "p99 hold ns" << '\n';
+
+    for (const auto& snapshot : snapshot()) {
+        os << std::left << std::setw(48) << snapshot.name
+            << std::right << std::setw(14) << snapshot.acquisitions
+            << std::setw(12) << snapshot.contended
+            << std::setw(16) << snapshot.totalWait.count()
+            << std::setw(14) << Percentile(snapshot.waitHistogram, 0.5).count()
+            << std::setw(14) << Percentile(snapshot.waitHistogram, 0.99).count()
+            << std::setw(14) << Percentile(snapshot.holdHistogram, 0.5).count()
+            << std::setw(14) << Percentile(snapshot.holdHistogram, 0.99).count() << '\n';
+    }
+}
+
+void LockProfiler::reset()
+{
+    std::lock_guard lock{ m_mutex };
+    for (auto* profile : m_profiles) {
+        profile->reset();
+    }
+}
+
+} //! namespace atom::concurrency
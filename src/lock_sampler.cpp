@@ -0,0 +1,87 @@
+#include "include/concurrency/lock_sampler.h"
+
+#include "include/concurrency/lock_order_graph.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+namespace atom::concurrency {
+
+namespace {
+
+std::uint32_t IntervalFromEnvironment()
+{
+    const char* const value = std::getenv("ATOM_LOCK_SAMPLING");
+    return value ? static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10)) : 0;
+}
+
+void PrintViolation(const std::span<const std::uint32_t> held, const std::uint32_t acquiring)
+{
+    std::cerr << "atom: lock order violation: lock #" << acquiring << " is acquired while holding";
+    for (const auto id : held) {
+        std::cerr << " #" << id;
+    }
+    std::cerr << std::endl;
+}
+
+std::atomic<LockSampler::ReportHandlerType> reportHandler{ &PrintViolation };
+std::atomic<std::uint64_t> violationsCount{ 0 };
+
+} //! namespace
+
+std::atomic<std::uint32_t> LockSampler::s_interval{ IntervalFromEnvironment() };
+std::atomic<bool> LockSampler::s_everEnabled{ s_interval.load(std::memory_order_relaxed) != 0 };
+
+void LockSampler::setInterval(const std::uint32_t interval)
+{
+    if (interval != 0) {
+        s_everEnabled.store(true, std::memory_order_relaxed);
+    }
+    // A thread which sees the interval and fills its held set sees the flag on release as well
+    s_interval.store(interval, std::memory_order_release);
+}
+
+std::uint32_t LockSampler::interval()
+{
+    return s_interval.load(std::memory_order_relaxed);
+}
+
+void LockSampler::setReportHandler(const ReportHandlerType handler)
+{
+    reportHandler.store(handler ? handler : &PrintViolation, std::memory_order_relaxed);
+}
+
+std::uint64_t LockSampler::violations()
+{
+    return violationsCount.load(std::memory_order_relaxed);
+}
+
+void LockSampler::Sample(ThreadState& thread, const std::uint32_t id)
+{
+    if (thread.random == 0) {
+        thread.random = static_cast<std::uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1;
+    }
+
+    // xorshift32, the next sample is uniformly 1..2*interval-1 acquisitions away, that is the interval on average
+    thread.random ^= thread.random << 13;
+    thread.random ^= thread.random >> 17;
+    thread.random ^= thread.random << 5;
+    const auto interval = std::max(s_interval.load(std::memory_order_relaxed), std::uint32_t{ 1 });
+    thread.countdown = static_cast<std::uint32_t>(1 + thread.random % (2 * std::uint64_t{ interval } - 1));
+
+    const std::span<const std::uint32_t> held{ thread.held.data(), thread.size };
+    if (held.empty()) {
+        return;
+    }
+
+    const auto isHeld = std::find(held.begin(), held.end(), id) != held.end();
+    if (isHeld || !LockOrderGraph::instance().addEdges(held, id)) {
+        violationsCount.fetch_add(1, std::memory_order_relaxed);
+        reportHandler.load(std::memory_order_relaxed)(held, id);
+    }
+}
+
+} //! namespace atom::concurrency
@@ -0,0 +1,153 @@
+#include "include/concurrency/lock_tracer.h"
+
+#include <algorithm>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace atom::concurrency {
+
+namespace {
+
+struct TraceFile final {
+    int fd = -1;
+    void* data = nullptr;
+    std::size_t mappedSize = 0;
+
+    LockTraceHeader* header() const { return static_cast<LockTraceHeader*>(data); }
+    LockEvent* events() const { return reinterpret_cast<LockEvent*>(header() + 1); }
+};
+
+// Lock order: ringsMutex -> TraceRing::drainMutex -> fileMutex.
+// Drains hold fileMutex shared and copy into the mapping concurrently, start() and stop() remap it exclusively.
+std::mutex ringsMutex;
+std::vector<__details::TraceRing*> rings;
+std::shared_mutex fileMutex;
+TraceFile traceFile;
+std::atomic<std::uint32_t> nextThreadId{ 0 };
+
+} //! namespace
+
+std::atomic<bool> LockTracer::s_active{ false };
+
+bool LockTracer::start(const std::string& path, const std::size_t capacity)
+{
+    if (isActive()) {
+        return false;
+    }
+
+    {
+        // Forget the events recorded after the previous stop()
+        std::lock_guard ringsLock{ ringsMutex };
+        for (auto* const ring : rings) {
+            std::lock_guard drainLock{ ring->drainMutex };
+            ring->head.store(ring->tail.load(std::memory_order_acquire), std::memory_order_release);
+        }
+    }
+
+    std::unique_lock lock{ fileMutex };
+    if (traceFile.data) {
+        return false;
+    }
+
+    const auto fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    const auto mappedSize = sizeof(LockTraceHeader) + capacity * sizeof(LockEvent);
+    void* data = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(mappedSize)) == 0) {
+        data = ::mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+
+    if (data == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    traceFile = TraceFile{ fd, data, mappedSize };
+    *traceFile.header() = LockTraceHeader{
+        LockTraceHeader::MAGIC, LockTraceHeader::VERSION, sizeof(LockEvent), capacity, 0
+    };
+
+    s_active.store(true, std::memory_order_release);
+    return true;
+}
+
+void LockTracer::stop()
+{
+    s_active.store(false, std::memory_order_release);
+    {
+        std::lock_guard ringsLock{ ringsMutex };
+        for (auto* const ring : rings) {
+            Drain(*ring);
+        }
+    }
+
+    std::unique_lock lock{ fileMutex };
+    if (!traceFile.data) {
+        return;
+    }
+
+    const auto* const header = traceFile.header();
+    const auto recorded = std::min(header->size, header->capacity);
+    ::munmap(traceFile.data, traceFile.mappedSize);
+    [[maybe_unused]] const auto truncated = ::ftruncate(traceFile.fd,
+        static_cast<off_t>(sizeof(LockTraceHeader) + recorded * sizeof(LockEvent)));
+    ::close(traceFile.fd);
+    traceFile = TraceFile{};
+}
+
+LockTracer::RingType* LockTracer::RegisterThread()
+{
+    // The ring lives as long as its thread, the thread-local owner drains and unregisters it on the thread exit
+    struct RingOwner final {
+        std::unique_ptr<RingType> ring = std::make_unique<RingType>();
+
+        RingOwner() {
+            ring->threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard lock{ ringsMutex };
+            rings.push_back(ring.get());
+        }
+
+        ~RingOwner() {
+            std::lock_guard lock{ ringsMutex };
+            Drain(*ring);
+            rings.erase(std::find(rings.begin(), rings.end(), ring.get()));
+            CurrentRing() = nullptr;
+        }
+    };
+
+    thread_local RingOwner owner;
+    CurrentRing() = owner.ring.get();
+    return owner.ring.get();
+}
+
+void LockTracer::Drain(RingType& ring)
+{
+    std::lock_guard drainLock{ ring.drainMutex };
+    const auto head = ring.head.load(std::memory_order_relaxed);
+    const auto tail = ring.tail.load(std::memory_order_acquire);
+    if (head == tail) {
+        return;
+    }
+
+    std::shared_lock fileLock{ fileMutex };
+    if (traceFile.data) {
+        auto* const header = traceFile.header();
+        const auto first = std::atomic_ref{ header->size }.fetch_add(tail - head, std::memory_order_relaxed);
+        const auto count = first < header->capacity ? std::min(tail - head, header->capacity - first) : 0;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            traceFile.events()[first + i] = ring.events[(head + i) % RingType::SIZE];
+        }
+    }
+
+    ring.head.store(tail, std::memory_order_release);
+}
+
+} //! namespace atom::concurrency
@@ -0,0 +1,262 @@
+#include "include/concurrency/lock_watchdog.h"
+
+#include "include/concurrency/safe_mutex.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace atom::concurrency {
+
+namespace {
+
+using WaitRecord = __details::WaitRecord;
+
+void PrintReport(const std::string_view report)
+{
+    std::cerr << report << std::flush;
+}
+
+std::atomic<LockWatchdog::ReportHandlerType> reportHandler{ &PrintReport };
+std::atomic<std::uint64_t> reportsCount{ 0 };
+
+// The wait-for table, records are pushed at the head
+std::mutex tableMutex;
+WaitRecord* tableHead = nullptr;
+
+// Lock order: controlMutex -> threadMutex. The watchdog thread takes threadMutex only
+std::mutex controlMutex;
+std::mutex threadMutex;
+std::condition_variable threadCondVar;
+std::thread watchdogThread;
+bool stopRequested = false;
+LockWatchdog::ClockType::duration waitThreshold;
+WatchdogAction watchdogAction = WatchdogAction::Report;
+
+std::int64_t ToMilliseconds(const LockWatchdog::ClockType::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+}
+
+// The waiter whose LockStory holds the awaited lock, -1 if the owner doesn't wait (or it is an external wait)
+std::ptrdiff_t FindOwner(const std::vector<const WaitRecord*>& waits, const std::size_t waiter)
+{
+    const auto lockId = waits[waiter]->lockId;
+    if (lockId == WaitRecord::NO_LOCK) {
+        return -1;
+    }
+
+    for (std::size_t i = 0; i < waits.size(); ++i) {
+        const auto* const held = waits[i]->held.data();
+        if (i != waiter && std::find(held, held + waits[i]->heldCount, lockId) != held + waits[i]->heldCount) {
+            return static_cast<std::ptrdiff_t>(i);
+        }
+    }
+    return -1;
+}
+
+void DescribeWait(std::ostream& stream, const WaitRecord& record, const LockWatchdog::ClockType::time_point now)
+{
+    stream << "  thread " << record.threadId << " (story " << record.story << ") waits "
+        << ToMilliseconds(now - record.since) << " ms for ";
+    if (record.lockId == WaitRecord::NO_LOCK) {
+        stream << '"' << record.what << '"';
+    } else {
+        stream << "lock #" << record.lockId;
+    }
+
+    stream << ", holds";
+    if (record.heldCount == 0) {
+        stream << " nothing";
+    }
+    for (std::size_t i = 0; i < record.heldCount; ++i) {
+        stream << " #" << record.held[i];
+    }
+    stream << '\n';
+}
+
+} //! namespace
+
+std::atomic<bool> LockWatchdog::s_active{ false };
+
+LockWatchdog::WaitGuard::WaitGuard(const LockStory& lockStory, const std::string_view what):
+m_record(),
+m_registered(isActive())
+{
+    if (m_registered) {
+        m_record.what = what;
+        Register(m_record, lockStory);
+    }
+}
+
+LockWatchdog::WaitGuard::WaitGuard(const LockStory& lockStory, const std::uint32_t lockId):
+m_record(),
+m_registered(isActive())
+{
+    if (m_registered) {
+        m_record.lockId = lockId;
+        Register(m_record, lockStory);
+    }
+}
+
+LockWatchdog::WaitGuard::~WaitGuard()
+{
+    if (m_registered) {
+        Unregister(m_record);
+    }
+}
+
+bool LockWatchdog::start(const ClockType::duration threshold, const WatchdogAction action)
+{
+    std::lock_guard controlLock{ controlMutex };
+    if (watchdogThread.joinable()) {
+        return false;
+    }
+
+    {
+        std::lock_guard lock{ threadMutex };
+        stopRequested = false;
+        waitThreshold = threshold;
+        watchdogAction = action;
+    }
+
+    s_active.store(true, std::memory_order_relaxed);
+    watchdogThread = std::thread{[] {
+        const auto period = std::max<ClockType::duration>(waitThreshold / 2, std::chrono::milliseconds(1));
+        std::unique_lock lock{ threadMutex };
+        while (!threadCondVar.wait_for(lock, period, [] { return stopRequested; })) {
+            lock.unlock();
+            Scan();
+            lock.lock();
+        }
+    }};
+    return true;
+}
+
+void LockWatchdog::stop()
+{
+    std::lock_guard controlLock{ controlMutex };
+    if (!watchdogThread.joinable()) {
+        return;
+    }
+
+    // The registered waits unregister themselves when they finish
+    s_active.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard lock{ threadMutex };
+        stopRequested = true;
+    }
+    threadCondVar.notify_one();
+    watchdogThread.join();
+}
+
+void LockWatchdog::setReportHandler(const ReportHandlerType handler)
+{
+    reportHandler.store(handler ? handler : &PrintReport, std::memory_order_relaxed);
+}
+
+std::uint64_t LockWatchdog::reports()
+{
+    return reportsCount.load(std::memory_order_relaxed);
+}
+
+void LockWatchdog::Register(WaitRecord& record, const LockStory& lockStory)
+{
+    record.story = &lockStory;
+    record.threadId = std::this_thread::get_id();
+    record.since = ClockType::now();
+#ifdef ATOM_CHECKED_BUILD
+    // SafeMutex::lock() puts the awaited lock into the story before it blocks, it is not held yet
+    for (std::size_t i = 0; i < lockStory.m_size && record.heldCount < WaitRecord::MAX_HELD_LOCKS; ++i) {
+        if (lockStory.m_storage[i].id != record.lockId) {
+            record.held[record.heldCount++] = lockStory.m_storage[i].id;
+        }
+    }
+#endif
+
+    std::lock_guard lock{ tableMutex };
+    record.next = tableHead;
+    if (tableHead) {
+        tableHead->prev = &record;
+    }
+    tableHead = &record;
+}
+
+void LockWatchdog::Unregister(WaitRecord& record)
+{
+    std::lock_guard lock{ tableMutex };
+    (record.prev ? record.prev->next : tableHead) = record.next;
+    if (record.next) {
+        record.next->prev = record.prev;
+    }
+}
+
+void LockWatchdog::Scan()
+{
+    std::ostringstream report;
+    {
+        std::lock_guard lock{ tableMutex };
+        const auto now = ClockType::now();
+        std::vector<const WaitRecord*> waits;
+        std::size_t stuckCount = 0;
+        auto hasNewStuck = false;
+        for (auto* record = tableHead; record; record = record->next) {
+            waits.push_back(record);
+            if (now - record->since >= waitThreshold) {
+                ++stuckCount;
+                hasNewStuck |= !record->reported;
+                record->reported = true;
+            }
+        }
+
+        if (!hasNewStuck) {
+            return;
+        }
+
+        report << "atom: watchdog: " << stuckCount << " wait(s) longer than " << ToMilliseconds(waitThreshold)
+            << " ms, wait-for table:\n";
+        std::vector<std::ptrdiff_t> owners(waits.size());
+        for (std::size_t i = 0; i < waits.size(); ++i) {
+            DescribeWait(report, *waits[i], now);
+            owners[i] = FindOwner(waits, i);
+        }
+
+        // Every waiter waits for a single owner, so following the owners from each waiter finds every cycle once
+        enum class Color : std::uint8_t { White, OnPath, Done };
+        std::vector<Color> colors(waits.size(), Color::White);
+        for (std::size_t start = 0; start < waits.size(); ++start) {
+            auto current = static_cast<std::ptrdiff_t>(start);
+            while (current >= 0 && colors[current] == Color::White) {
+                colors[current] = Color::OnPath;
+                current = owners[current];
+            }
+
+            if (current >= 0 && colors[current] == Color::OnPath) {
+                report << "  deadlock:";
+                auto member = current;
+                do {
+                    report << " thread " << waits[member]->threadId << " -> lock #" << waits[member]->lockId << " ->";
+                    member = owners[member];
+                } while (member != current);
+                report << " thread " << waits[current]->threadId << '\n';
+            }
+
+            for (auto member = static_cast<std::ptrdiff_t>(start); member >= 0 && colors[member] == Color::OnPath;
+                member = owners[member]) {
+                colors[member] = Color::Done;
+            }
+        }
+    }
+
+    reportsCount.fetch_add(1, std::memory_order_relaxed);
+    reportHandler.load(std::memory_order_relaxed)(report.str());
+    if (watchdogAction == WatchdogAction::Abort) {
+        std::abort();
+    }
+}
+
+} //! namespace atom::concurrency
@@ -0,0 +1,272 @@
+#include "include/concurrency/queue_lock.h"
+
+#include "include/utils/assertion.h"
+#include "include/utils/cpu_relax.h"
+
+#include <cassert>
+#include <thread>
+#include <vector>
+
+namespace atom::concurrency {
+
+namespace {
+
+using QueueNode = __details::QueueNode;
+
+// A waiter spins with a pause this many times before it starts to yield its core between the checks
+constexpr std::uint32_t SPIN_LIMIT = 128;
+
+// Free queue nodes of the thread. The CLH nodes migrate between the threads, so the cache owns whatever it holds
+class NodeCache final {
+public:
+    explicit NodeCache(): m_nodes() {}
+
+    ~NodeCache() {
+        for (auto* node : m_nodes) {
+            delete node;
+        }
+    }
+
+    NodeCache(const NodeCache& ) = delete;
+    NodeCache& operator=(const NodeCache& ) = delete;
+
+    QueueNode* take() {
+        if (m_nodes.empty()) {
+            return new QueueNode{};
+        }
+
+        auto* node = m_nodes.back();
+        m_nodes.pop_back();
+        return node;
+    }
+
+    void give(QueueNode* node) { m_nodes.push_back(node); }
+
+private:
+    std::vector<QueueNode*> m_nodes;
+};
+
+thread_local NodeCache nodeCache;
+
+void AwaitGrant(const std::atomic<bool>& locked, const LockStory& lockStory, const std::uint32_t id)
+{
+    for (std::uint32_t i = 0; i < SPIN_LIMIT; ++i) {
+        if (!locked.load(std::memory_order_acquire)) {
+            return;
+        }
+        utils::CpuRelax();
+    }
+
+    // The predecessors hold the lock for long or are preempted, the core is better used by them
+    const LockWatchdog::WaitGuard waitGuard{ lockStory, id };
+    while (locked.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+} //! namespace
+
+namespace __details {
+
+void QueueLockChecks::onLock([[maybe_unused]] LockStory& lockStory, const std::uint32_t id)
+{
+#ifdef ATOM_CHECKED_BUILD
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        PANIC(!lockStory.recordLockOrder(id));
+        lockStory.add(id, LockMode::Exclusive);
+    }
+#else
+    LockSampler::onAcquiring(id);
+#endif
+}
+
+bool QueueLockChecks::onTryLock([[maybe_unused]] LockStory& lockStory, [[maybe_unused]] const std::uint32_t id)
+{
+#ifdef ATOM_CHECKED_BUILD
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        return lockStory.find(id) == nullptr;
+    }
+#endif
+    return true;
+}
+
+void QueueLockChecks::onLocked([[maybe_unused]] LockStory& lockStory, const std::uint32_t id)
+{
+#ifdef ATOM_CHECKED_BUILD
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        lockStory.add(id, LockMode::Exclusive);
+    }
+#else
+    LockSampler::onAcquired(id);
+#endif
+}
+
+void QueueLockChecks::onUnlock([[maybe_unused]] LockStory& lockStory, const std::uint32_t id)
+{
+#ifdef ATOM_CHECKED_BUILD
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        lockStory.remove(id);
+    }
+#else
+    LockSampler::onReleased(id);
+#endif
+}
+
+} //! namespace __details
+
+McsLock::McsLock():
+m_id(__details::GenerateLockId()),
+m_tail(nullptr),
+m_owner(nullptr)
+{}
+
+McsLock::~McsLock()
+{
+    assert(m_tail.load(std::memory_order_relaxed) == nullptr);
+    __details::ReleaseLockId(m_id);
+}
+
+void McsLock::lock(LockStory& lockStory)
+{
+    __details::QueueLockChecks::onLock(lockStory, m_id);
+    acquire(lockStory);
+}
+
+void McsLock::unlock(LockStory& lockStory)
+{
+    __details::QueueLockChecks::onUnlock(lockStory, m_id);
+    release();
+}
+
+LockResultType McsLock::tryLock(LockStory& lockStory)
+{
+    if (!__details::QueueLockChecks::onTryLock(lockStory, m_id)) [[unlikely]] {
+        return LockResultType::onError(LockError::Deadlock);
+    }
+
+    auto* node = nodeCache.take();
+    node->next.store(nullptr, std::memory_order_relaxed);
+    node->locked.store(true, std::memory_order_relaxed);
+
+    QueueNode* expected = nullptr;
+    if (!m_tail.compare_exchange_strong(expected, node, std::memory_order_acquire, std::memory_order_relaxed)) {
+        nodeCache.give(node);
+        return LockResultType::onError(LockError::WouldBlock);
+    }
+
+    m_owner = node;
+    __details::QueueLockChecks::onLocked(lockStory, m_id);
+    return LockResultType::onOk();
+}
+
+void McsLock::lock()
+{
+    lock(LockStory::current());
+}
+
+void McsLock::unlock()
+{
+    unlock(LockStory::current());
+}
+
+bool McsLock::try_lock()
+{
+    return tryLock(LockStory::current()).isOk();
+}
+
+void McsLock::acquire(const LockStory& lockStory)
+{
+    auto* node = nodeCache.take();
+    node->next.store(nullptr, std::memory_order_relaxed);
+    node->locked.store(true, std::memory_order_relaxed);
+
+    // acq_rel: the exchange both publishes the node and synchronizes with the release of an uncontended holder
+    auto* pred = m_tail.exchange(node, std::memory_order_acq_rel);
+    if (pred) {
+        pred->next.store(node, std::memory_order_release);
+        AwaitGrant(node->locked, lockStory, m_id);
+    }
+
+    m_owner = node;
+}
+
+void McsLock::release()
+{
+    auto* node = m_owner;
+    auto* next = node->next.load(std::memory_order_acquire);
+    if (!next) {
+        auto expected = node;
+        if (m_tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed)) {
+            nodeCache.give(node);
+            return;
+        }
+
+        // A successor has swapped the tail already but hasn't linked itself to our node yet
+        while (!(next = node->next.load(std::memory_order_acquire))) {
+            utils::CpuRelax();
+        }
+    }
+
+    next->locked.store(false, std::memory_order_release);
+    nodeCache.give(node);
+}
+
+ClhLock::ClhLock():
+m_id(__details::GenerateLockId()),
+m_tail(new QueueNode{}),
+m_owner(nullptr),
+m_ownerPred(nullptr)
+{}
+
+ClhLock::~ClhLock()
+{
+    auto* tail = m_tail.load(std::memory_order_relaxed);
+    assert(!tail->locked.load(std::memory_order_relaxed));
+    delete tail;
+    __details::ReleaseLockId(m_id);
+}
+
+void ClhLock::lock(LockStory& lockStory)
+{
+    __details::QueueLockChecks::onLock(lockStory, m_id);
+    acquire(lockStory);
+}
+
+void ClhLock::unlock(LockStory& lockStory)
+{
+    __details::QueueLockChecks::onUnlock(lockStory, m_id);
+    release();
+}
+
+void ClhLock::lock()
+{
+    lock(LockStory::current());
+}
+
+void ClhLock::unlock()
+{
+    unlock(LockStory::current());
+}
+
+void ClhLock::acquire(const LockStory& lockStory)
+{
+    auto* node = nodeCache.take();
+    node->locked.store(true, std::memory_order_relaxed);
+
+    auto* pred = m_tail.exchange(node, std::memory_order_acq_rel);
+    AwaitGrant(pred->locked, lockStory, m_id);
+
+    m_owner = node;
+    m_ownerPred = pred;
+}
+
+void ClhLock::release()
+{
+    // Nobody reads the predecessor node any more, while our node stays in the queue until the successor is done
+    auto* node = m_owner;
+    auto* pred = m_ownerPred;
+    node->locked.store(false, std::memory_order_release);
+    nodeCache.give(pred);
+}
+
+} //! namespace atom::concurrency
@@ -0,0 +1,28 @@
+#include "include/concurrency/runtime_checks.h"
+
+#include <cstdlib>
+
+namespace atom::concurrency {
+
+#if defined(NDEBUG) && defined(ATOM_RUNTIME_CHECKS)
+
+namespace {
+
+bool EnabledFromEnvironment()
+{
+    const char* const value = std::getenv("ATOM_RUNTIME_CHECKS");
+    return value && std::strtoul(value, nullptr, 10) != 0;
+}
+
+} //! namespace
+
+std::atomic<bool> RuntimeChecks::s_enabled{ EnabledFromEnvironment() };
+
+void RuntimeChecks::setEnabled(const bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+#endif //! if defined(NDEBUG) && defined(ATOM_RUNTIME_CHECKS)
+
+} //! namespace atom::concurrency
@@ -0,0 +1,127 @@
+#include "include/concurrency/safe_condition_variable.h"
+
+#include "include/utils/assertion.h"
+
+namespace atom::concurrency {
+
+#ifdef ATOM_CHECKED_BUILD
+
+SafeConditionVariable::SafeConditionVariable():
+m_mutex(nullptr),
+m_waiters()
+{}
+
+SafeConditionVariable::~SafeConditionVariable()
+{
+    assert(m_waiters.head == nullptr);
+}
+
+void SafeConditionVariable::notifyOne()
+{
+    notify(false);
+}
+
+void SafeConditionVariable::notifyAll()
+{
+    notify(true);
+}
+
+void SafeConditionVariable::bind(SafeMutex& mutex)
+{
+    SafeMutex* expected = nullptr;
+    if (!m_mutex.compare_exchange_strong(expected, &mutex, std::memory_order_release, std::memory_order_relaxed)) {
+        PANIC(expected != &mutex);
+    }
+}
+
+void SafeConditionVariable::notify(const bool all)
+{
+    auto* const mutex = m_mutex.load(std::memory_order_acquire);
+    if (!mutex) {
+        // Nobody has waited yet
+        return;
+    }
+
+    // The waiters to wake up are chained through `next`, they leave the list before the notification
+    SafeMutex::WaitNode* woken = nullptr;
+    {
+        std::lock_guard lock{ mutex->m_mutex };
+        while (auto* const node = m_waiters.pop()) {
+            if (!mutex->enqueueNotified(*node)) {
+                node->state = SafeMutex::WaitState::Notified;
+                node->notifying.store(true, std::memory_order_relaxed);
+                node->next = woken;
+                woken = node;
+            }
+
+            if (!all) {
+                break;
+            }
+        }
+    }
+
+    while (woken) {
+        auto* const next = woken->next;
+        woken->condVar.notify_one();
+        // The last access to the node, the waiter may destroy it right after this store
+        woken->notifying.store(false, std::memory_order_release);
+        woken = next;
+    }
+}
+
+bool SafeConditionVariable::waitUntilImpl(SafeMutex& mutex, LockStory& lockStory,
+    const ClockType::time_point* const deadline)
+{
+    using WaitState = SafeMutex::WaitState;
+
+    bind(mutex);
+    SafeMutex::WaitNode node;
+    std::unique_lock lock{ mutex.m_mutex };
+    // The node is listed before the mutex is released, so a notification issued under the mutex can't be lost
+    m_waiters.push(node, WaitState::Waiting);
+    lock.unlock();
+    mutex.unlock(lockStory);
+
+    auto noTimeout = true;
+    {
+        // The morphed part of the wait is a wait for the mutex, it is reported as a part of the condition wait
+        const LockWatchdog::WaitGuard waitGuard{ lockStory, "SafeConditionVariable" };
+        lock.lock();
+        const auto notified = [&node]{ return node.state != WaitState::Waiting; };
+        if (deadline) {
+            noTimeout = node.condVar.wait_until(lock, *deadline, notified);
+            if (!noTimeout) {
+                m_waiters.erase(node);
+            }
+        } else {
+            node.condVar.wait(lock, notified);
+        }
+
+        if (node.state == WaitState::Queued || node.state == WaitState::HandedOff) {
+            // Morphed into a waiter of the mutex: it is handed off to us by the unlocker like to any other waiter,
+            // and the re-acquisition is checked against the locks held meanwhile like SafeMutex::lock() does
+            const auto checked = RuntimeChecks::enabled();
+            if (checked) [[unlikely]] {
+                mutex.checkLockOrder(lockStory);
+            } else {
+                LockSampler::onAcquiring(mutex.m_id);
+            }
+            mutex.lockQueued(lockStory, node, lock, nullptr);
+            if (checked) [[unlikely]] {
+                lockStory.add(mutex.m_id, LockMode::Exclusive);
+            }
+            // The wait for the mutex began when the notifier queued the node, it is a contended acquisition
+            mutex.onAcquire(true, node.queuedAt);
+            return true;
+        }
+        lock.unlock();
+    }
+
+    SafeMutex::AwaitNotifier(node);
+    mutex.lock(lockStory);
+    return noTimeout;
+}
+
+#endif //! ifdef ATOM_CHECKED_BUILD
+
+} //! namespace atom::concurrency
@@ -1,156 +1,642 @@
 #include "include/concurrency/safe_mutex.h"
 
+#include "include/concurrency/lock_order_graph.h"
 #include "include/utils/assertion.h"
+#include "include/utils/cpu_relax.h"
 
-#include <array>
+#include <algorithm>
+#include <thread>
 
-namespace {
+namespace atom::concurrency {
 
-struct Node;
-struct NodeHash;
+void MakeGraph(const LockStory::StoryListType& first, const LockStory::StoryListType& second, LockStory::GraphType& graph) {
+    for (const auto* storyStorage : { &first, &second }) {
+        if (storyStorage->empty()) {
+            continue;
+        }
 
-using namespace atom::concurrency;
+        auto currentIt = storyStorage->cbegin();
+        auto nextIt = std::next(currentIt);
+        while (nextIt != storyStorage->cend()) {
+            assert(*currentIt != nullptr && *nextIt != nullptr);
 
-struct Node final {
-    const SafeMutex* fromMutex;
-    const SafeMutex* toMutex;
+            graph.insert(std::make_pair(*currentIt, *nextIt));
+            ++currentIt;
+            ++nextIt;
+        }
+    }
+}
+
+bool CheckIntersections(const LockStory::GraphType& graph) {
+    // The edges go to a private graph, which rejects the first one closing a cycle of any length
+    LockOrderGraph orderGraph;
+    return !std::ranges::all_of(graph, [&orderGraph](const auto& edge) {
+        return orderGraph.addEdge(edge.first->id(), edge.second->id());
+    });
+}
 
-    explicit Node(const SafeMutex* _fromMutex, const SafeMutex* _toMutex);
-    bool operator==(const Node& other) const;
+namespace {
+
+// Ids given back by the destroyed locks beyond the capacity of the thread caches. It is never destroyed: the locks
+// with static storage duration give their ids back during the exit
+struct FreeLockIds final {
+    std::mutex mutex;
+    std::vector<std::uint32_t> ids;
+    std::atomic<std::size_t> size = 0;
 };
 
-struct NodeHash final {
-    explicit NodeHash() = default;
-    std::size_t operator()(const Node& node) const noexcept;
+FreeLockIds& GetFreeLockIds() {
+    static auto* const freeIds = new FreeLockIds{};
+    return *freeIds;
+}
+
+// The ids the thread has released lately. It is trivially destructible, so the locks destroyed after the
+// thread-local objects of the thread still can use it, the ids cached by an exiting thread are lost
+struct ThreadLockIds final {
+    static constexpr std::size_t CAPACITY = 32;
+
+    std::array<std::uint32_t, CAPACITY> ids;
+    std::size_t size;
 };
 
+thread_local ThreadLockIds threadLockIds{};
+std::atomic<std::uint32_t> nextLockId{ 0 };
+
+} //! namespace
+
+namespace __details {
+
+std::uint32_t GenerateLockId() {
+    auto& cache = threadLockIds;
+    if (cache.size == 0) {
+        auto& freeIds = GetFreeLockIds();
+        if (freeIds.size.load(std::memory_order_relaxed) == 0) {
+            return nextLockId.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::lock_guard lock{ freeIds.mutex };
+        const auto count = std::min(freeIds.ids.size(), ThreadLockIds::CAPACITY / 2);
+        std::copy(freeIds.ids.cend() - count, freeIds.ids.cend(), cache.ids.begin());
+        freeIds.ids.resize(freeIds.ids.size() - count);
+        freeIds.size.store(freeIds.ids.size(), std::memory_order_relaxed);
+        cache.size = count;
+        if (count == 0) {
+            return nextLockId.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    return cache.ids[--cache.size];
+}
+
+void ReleaseLockId(const std::uint32_t id) {
+#ifdef ATOM_LOCK_TRACING
+    LockTracer::record(LockEventType::Destroy, id, std::chrono::nanoseconds::zero());
+#endif
+    // The node is gone before the id can be reused
+    LockOrderGraph::instance().removeNode(id);
+
+    auto& cache = threadLockIds;
+    if (cache.size == ThreadLockIds::CAPACITY) {
+        // Half of the cache goes to the shared list, so a thread which only destroys locks takes the mutex rarely
+        auto& freeIds = GetFreeLockIds();
+        std::lock_guard lock{ freeIds.mutex };
+        const auto count = ThreadLockIds::CAPACITY / 2;
+        freeIds.ids.insert(freeIds.ids.end(), cache.ids.cbegin() + count, cache.ids.cend());
+        freeIds.size.store(freeIds.ids.size(), std::memory_order_relaxed);
+        cache.size = count;
+    }
+    cache.ids[cache.size++] = id;
+}
+
+} //! namespace __details
+
+void LockAll(LockStory& lockStory, const std::span<SafeMutex* const> mutexes) {
+    if (mutexes.empty()) {
+        return;
+    }
+
+    std::vector<SafeMutex*> group{ mutexes.begin(), mutexes.end() };
+    std::sort(group.begin(), group.end(), [](const SafeMutex* lhs, const SafeMutex* rhs) {
+        return lhs->id() < rhs->id();
+    });
+    // The same mutex twice in one group is a self deadlock
+    PANIC(std::adjacent_find(group.cbegin(), group.cend()) != group.cend());
+
+#ifdef ATOM_CHECKED_BUILD
+    if (RuntimeChecks::enabled()) {
+        PANIC(lockStory.size() + group.size() > LockStory::MAX_STORY_SIZE);
+        for (const auto* mutex : group) {
+            PANIC(!lockStory.recordLockOrder(mutex->id()));
+        }
+    } else {
+        // The group is taken in the canonical order, so it is sampled as if it was locked one by one in that order
+        for (const auto* mutex : group) {
+            LockSampler::onAcquiring(mutex->id());
+        }
+    }
+#endif
+
+    std::size_t first = 0;
+    while (true) {
+        group[first]->acquire(lockStory);
+
+        auto failed = group.size();
+        for (std::size_t i = 1; i < group.size(); ++i) {
+            const auto index = (first + i) % group.size();
+            if (!group[index]->tryAcquire(lockStory)) {
+                failed = index;
+                break;
+            }
+        }
+
+        if (failed == group.size()) {
+            break;
+        }
+
+        for (auto i = first; i != failed; i = (i + 1) % group.size()) {
+            group[i]->release(lockStory);
+        }
+
+        // Next time block on the mutex which was busy rather than spin on the same one
+        first = failed;
+        std::this_thread::yield();
+    }
+
+#ifdef ATOM_CHECKED_BUILD
+    if (RuntimeChecks::enabled()) {
+        for (const auto* mutex : group) {
+            lockStory.add(mutex->id(), LockMode::Exclusive);
+        }
+    }
+#endif
+}
+
+void UnlockAll(LockStory& lockStory, const std::span<SafeMutex* const> mutexes) {
+    for (auto* mutex : mutexes) {
+        mutex->unlock(lockStory);
+    }
+}
+
+#ifdef ATOM_CHECKED_BUILD
 
-Node::Node(const SafeMutex* _fromMutex, const SafeMutex* _toMutex):
-fromMutex(_fromMutex), toMutex(_toMutex)
+LockStory::LockStory():
+m_storage(),
+m_size(0)
 {}
 
-inline bool Node::Node::operator==(const Node& other) const {
-    return NodeHash{}.operator()(other) == NodeHash{}.operator()(*this);
+LockStory& LockStory::current() {
+    thread_local LockStory lockStory;
+    return lockStory;
 }
 
-inline std::size_t NodeHash::NodeHash::operator()(const Node& node) const noexcept {
-    return ((std::uintptr_t)(node.fromMutex) + (std::uintptr_t)(node.toMutex)) % std::numeric_limits<std::size_t>::max();
+std::size_t LockStory::size() const {
+    return m_size;
 }
 
-} //! namespace
+bool LockStory::empty() const {
+    return m_size == 0;
+}
 
-namespace atom::concurrency {
+void LockStory::add(const std::uint32_t id, const LockMode mode) {
+    PANIC(m_size == MAX_STORY_SIZE);
+    m_storage[m_size++] = HeldLock{ id, mode };
+}
 
-void MakeGraph(const LockStory::StoryListType& first, const LockStory::StoryListType& second, LockStory::GraphType& graph) {
-    const std::array w = { first, second };
-    for (const auto& storyStorage : w) {
-        auto currentIt = storyStorage.cbegin();
-        auto nextIt = std::next(currentIt);
-        while (nextIt != storyStorage.cend()) {
-            assert(*currentIt != nullptr && *nextIt != nullptr);
+void LockStory::remove(const std::uint32_t id) {
+    // Locks are usually released in LIFO order, so the lookup starts from the top of the story
+    for (auto i = m_size; i > 0; --i) {
+        if (m_storage[i - 1].id == id) {
+            std::copy(m_storage.cbegin() + i, m_storage.cbegin() + m_size, m_storage.begin() + (i - 1));
+            --m_size;
+            return;
+        }
+    }
+}
 
-            graph.insert(std::make_pair(*currentIt, *nextIt));
-            ++currentIt;
-            ++nextIt;
+const LockStory::HeldLock* LockStory::find(const std::uint32_t id) const {
+    for (auto i = m_size; i > 0; --i) {
+        if (m_storage[i - 1].id == id) {
+            return &m_storage[i - 1];
         }
     }
+
+    return nullptr;
 }
 
-bool CheckIntersections(const LockStory::GraphType& graph) {
-    if (graph.size() == 1) {
-        const SafeMutex* fromMutex = graph.cbegin()->first;
-        const SafeMutex* toMutex = graph.cbegin()->second;
-        return (fromMutex == toMutex);
-    }
-
-    std::unordered_set<Node, NodeHash> visited;
-    for (auto it = graph.begin(); it != graph.end(); ++it) {
-        const SafeMutex* fromMutex = it->first;
-        const SafeMutex* toMutex = it->second;
-        const Node node{ fromMutex, toMutex };
-
-        const auto foundNodeIt = visited.find(node);
-        if (foundNodeIt == visited.end()) {
-            auto [_, inserted] = visited.insert(node);
-            assert(inserted);
-        } else {
-            // To make sure that really same graph edges (in case hash collision)
-            if (foundNodeIt->fromMutex == toMutex && foundNodeIt->toMutex == fromMutex) {
-                return true;
-            }
+bool LockStory::recordLockOrder(const std::uint32_t id) const {
+    // The held set goes to the graph at once: known edges are a lookup per held lock, and new ones are checked
+    // for a cycle with a single search for the held set among the locks reachable from the lock
+    std::array<LockOrderGraph::NodeType, MAX_STORY_SIZE> held;
+    for (auto i = std::size_t{ 0 }; i < m_size; ++i) {
+        if (m_storage[i].id == id) {
+            return false;
         }
+        held[i] = m_storage[i].id;
     }
 
-    return false;
+    return m_size == 0 || LockOrderGraph::instance().addEdges({ held.data(), m_size }, id);
+}
+
+SafeMutex::SafeMutex([[maybe_unused]] const std::string_view name, const WaitPolicy policy):
+m_id(__details::GenerateLockId()),
+m_policy(policy),
+m_spinLimit(INITIAL_SPIN_LIMIT),
+m_state(UNLOCKED_STATE),
+m_waiters(),
+m_mutex()
+{
+#ifdef ATOM_LOCK_PROFILING
+    m_profile = std::make_unique<LockProfile>(LockProfile::NameOf(name));
+#endif
 }
 
-#ifndef NDEBUG
+SafeMutex::SafeMutex(const WaitPolicy policy, [[maybe_unused]] const std::source_location& location):
+m_id(__details::GenerateLockId()),
+m_policy(policy),
+m_spinLimit(INITIAL_SPIN_LIMIT),
+m_state(UNLOCKED_STATE),
+m_waiters(),
+m_mutex()
+{
+#ifdef ATOM_LOCK_PROFILING
+    m_profile = std::make_unique<LockProfile>(LockProfile::NameOf(location));
+#endif
+}
 
-LockStory::LockStory(std::size_t storySizeHint):
-m_storage() {
-    m_storage.reserve(storySizeHint);
+SafeMutex::~SafeMutex()
+{
+    __details::ReleaseLockId(m_id);
 }
 
-void LockStory::add(const SafeMutex& safeMutex) {
-    m_storage.push_back(&safeMutex);
+std::uint32_t SafeMutex::id() const
+{
+    return m_id;
 }
 
-void LockStory::remove(const SafeMutex& safeMutex) {
-    const auto it = std::find(m_storage.cbegin(), m_storage.cend(), &safeMutex);
-    if (it != m_storage.cend()) {
-        m_storage.erase(it);
+void SafeMutex::lock(LockStory& lockStory)
+{
+    // Without the runtime checks the LockStory is only the owner token, the lock order is sampled as in release
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        checkLockOrder(lockStory);
+        lockStory.add(m_id, LockMode::Exclusive);
+    } else {
+        LockSampler::onAcquiring(m_id);
     }
+    acquire(lockStory);
 }
 
-SafeMutex::SafeMutex():
-m_graph(),
-m_currentOwner(nullptr),
-m_waitQueue(),
-m_condVar(),
-m_mutex(),
-m_flag(false)
-{}
+void SafeMutex::unlock(LockStory& lockStory)
+{
+    assert(ToOwner(m_state.load(std::memory_order_relaxed)) == &lockStory);
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        lockStory.remove(m_id);
+    } else {
+        LockSampler::onReleased(m_id);
+    }
+    release(lockStory);
+}
 
-void SafeMutex::lock(LockStory& lockStory)
+LockResultType SafeMutex::tryLock(LockStory& lockStory)
 {
-    std::unique_lock lock{ m_mutex };
-    lockStory.add(*this);
+    const auto checked = RuntimeChecks::enabled();
+    if (checked && lockStory.find(m_id) != nullptr) [[unlikely]] {
+        return LockResultType::onError(LockError::Deadlock);
+    }
 
-    if (!m_currentOwner) {
-        m_currentOwner = &lockStory;
+    // A failed try can't deadlock, so there is no order check, the mutex enters the story only once it is held
+    if (!tryAcquire(lockStory)) {
+        return LockResultType::onError(LockError::WouldBlock);
+    }
+
+    if (checked) [[unlikely]] {
+        lockStory.add(m_id, LockMode::Exclusive);
     } else {
-        {
-            m_graph.clear();
-            MakeGraph(m_currentOwner->m_storage, lockStory.m_storage, m_graph);
-            PANIC(CheckIntersections(m_graph));
+        LockSampler::onAcquired(m_id);
+    }
+    return LockResultType::onOk();
+}
+
+void SafeMutex::lock()
+{
+    lock(LockStory::current());
+}
+
+void SafeMutex::unlock()
+{
+    unlock(LockStory::current());
+}
+
+bool SafeMutex::try_lock()
+{
+    return tryLock(LockStory::current()).isOk();
+}
+
+LockResultType SafeMutex::tryLockUntilImpl(LockStory& lockStory, const ClockType::time_point deadline)
+{
+    const auto checked = RuntimeChecks::enabled();
+    if (checked) [[unlikely]] {
+        if (!lockStory.recordLockOrder(m_id)) {
+            return LockResultType::onError(LockError::Deadlock);
         }
+    } else {
+        LockSampler::onAcquiring(m_id);
+    }
 
-        m_waitQueue.push(&lockStory);
-        m_condVar.wait(lock, [this]{ return m_flag; });
-        m_waitQueue.pop();
-        m_flag = false;
-        m_currentOwner = &lockStory;
+    if (!tryAcquire(lockStory) && !lockSlow(lockStory, &deadline)) {
+        if (!checked) {
+            LockSampler::onReleased(m_id);
+        }
+        return LockResultType::onError(LockError::Timeout);
+    }
+
+    if (checked) [[unlikely]] {
+        lockStory.add(m_id, LockMode::Exclusive);
     }
+    return LockResultType::onOk();
 }
 
-void SafeMutex::unlock(LockStory& lockStory)
+void SafeMutex::acquire(LockStory& lockStory)
+{
+    if (!tryAcquire(lockStory)) {
+        lockSlow(lockStory, nullptr);
+    }
+}
+
+bool SafeMutex::tryAcquire(LockStory& lockStory)
+{
+    auto expected = UNLOCKED_STATE;
+    if (!m_state.compare_exchange_strong(expected, ToState(&lockStory), std::memory_order_acquire, std::memory_order_relaxed)) {
+        // A barging mutex released to its waiters is free as well, we keep the flag for them
+        if (!canTakeOver(expected)
+            || !m_state.compare_exchange_strong(expected, ToState(&lockStory) | expected, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return false;
+        }
+    }
+
+    onAcquire(false, ClockType::time_point{});
+    return true;
+}
+
+bool SafeMutex::canTakeOver(const std::uintptr_t state) const
+{
+    // In FIFO mode an ownerless mutex with waiters is being handed off and belongs to the woken waiter
+    return ToOwner(state) == nullptr && (state == UNLOCKED_STATE || m_policy == WaitPolicy::Barging);
+}
+
+bool SafeMutex::spin(LockStory& lockStory)
+{
+    const auto spinLimit = m_spinLimit.load(std::memory_order_relaxed);
+    for (std::uint32_t i = 0; i < spinLimit; ++i) {
+        auto state = m_state.load(std::memory_order_relaxed);
+        if (canTakeOver(state)) {
+            if (m_state.compare_exchange_weak(state, ToState(&lockStory) | state, std::memory_order_acquire, std::memory_order_relaxed)) {
+                // Aim at twice the observed wait, so the usual hold time fits into the window with a margin
+                const auto target = std::clamp(2 * (i + 1), MIN_SPIN_LIMIT, MAX_SPIN_LIMIT);
+                m_spinLimit.store(spinLimit + (static_cast<std::int64_t>(target) - spinLimit) / 8, std::memory_order_relaxed);
+                return true;
+            }
+        } else if (m_policy == WaitPolicy::Fifo && (state & HAS_WAITERS_FLAG)) {
+            // There is a queue already, the mutex will be handed off to its head, not to us
+            break;
+        }
+
+        utils::CpuRelax();
+    }
+
+    m_spinLimit.store(std::max(spinLimit - spinLimit / 8, MIN_SPIN_LIMIT), std::memory_order_relaxed);
+    return false;
+}
+
+void SafeMutex::release(LockStory& lockStory)
+{
+    onRelease();
+
+    auto expected = ToState(&lockStory);
+    if (!m_state.compare_exchange_strong(expected, UNLOCKED_STATE, std::memory_order_release, std::memory_order_relaxed)) {
+        unlockSlow(lockStory);
+    }
+}
+
+bool SafeMutex::lockSlow(LockStory& lockStory, const ClockType::time_point* const deadline)
+{
+    const auto waitStart = WaitStart();
+    if (spin(lockStory)) {
+        onAcquire(true, waitStart);
+        return true;
+    }
+
+    // Only a waiter which is about to park shows up in the wait-for table of the watchdog
+    const LockWatchdog::WaitGuard waitGuard{ lockStory, m_id };
+    std::unique_lock lock{ m_mutex };
+    WaitNode node;
+    if (!lockQueued(lockStory, node, lock, deadline)) {
+        return false;
+    }
+
+    onAcquire(true, waitStart);
+    return true;
+}
+
+bool SafeMutex::lockQueued(LockStory& lockStory, WaitNode& node, std::unique_lock<std::mutex>& lock,
+    const ClockType::time_point* const deadline)
+{
+    while (true) {
+        if (node.state == WaitState::Idle) {
+            auto state = m_state.load(std::memory_order_relaxed);
+            if (canTakeOver(state)) {
+                const auto flags = m_waiters.head ? HAS_WAITERS_FLAG : UNLOCKED_STATE;
+                if (m_state.compare_exchange_weak(state, ToState(&lockStory) | flags, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    return true;
+                }
+                continue;
+            }
+
+            if (!(state & HAS_WAITERS_FLAG) && !m_state.compare_exchange_weak(state, state | HAS_WAITERS_FLAG, std::memory_order_relaxed)) {
+                continue;
+            }
+
+            // The owner can't leave through the fast path any more, it must come to unlockSlow and wake us up
+            m_waiters.push(node, WaitState::Queued);
+        }
+
+        const auto handedOff = [&node]{ return node.state == WaitState::HandedOff; };
+        if (deadline) {
+            if (!node.condVar.wait_until(lock, *deadline, handedOff)) {
+                m_waiters.erase(node);
+                if (!m_waiters.head) {
+                    // We were the last waiter, reopen the fast path for the current owner. An ownerless mutex is
+                    // being handed off to a dequeued waiter, the flag must keep newcomers off until it takes over
+                    auto state = m_state.load(std::memory_order_relaxed);
+                    while (ToOwner(state) != nullptr && (state & HAS_WAITERS_FLAG)
+                        && !m_state.compare_exchange_weak(state, state & ~HAS_WAITERS_FLAG, std::memory_order_relaxed)) {}
+                }
+                return false;
+            }
+        } else {
+            node.condVar.wait(lock, handedOff);
+        }
+
+        // unlockSlow has already dequeued the node
+        if (m_policy == WaitPolicy::Fifo) {
+            const auto flags = m_waiters.head ? HAS_WAITERS_FLAG : UNLOCKED_STATE;
+            m_state.store(ToState(&lockStory) | flags, std::memory_order_relaxed);
+            lock.unlock();
+            AwaitNotifier(node);
+            return true;
+        }
+
+        // Barging: the released mutex could be taken by a newcomer already, compete for it like everybody else
+        lock.unlock();
+        AwaitNotifier(node);
+        lock.lock();
+        node.state = WaitState::Idle;
+    }
+}
+
+void SafeMutex::unlockSlow(LockStory& /*lockStory*/)
 {
-    assert(m_currentOwner == &lockStory);
+    WaitNode* waiter = nullptr;
     {
         std::lock_guard lock{ m_mutex };
-        lockStory.remove(*this);
-
-        if (m_waitQueue.empty()) {
-            m_currentOwner = nullptr;
-            lockStory.remove(*this);
+        waiter = m_waiters.pop();
+        if (!waiter) {
+            m_state.store(UNLOCKED_STATE, std::memory_order_release);
             return;
         }
 
-        m_flag = true;
+        // Nobody owns the mutex, but the waiters flag keeps the fast path closed until a waiter takes it over
+        m_state.store(HAS_WAITERS_FLAG, std::memory_order_release);
+        waiter->state = WaitState::HandedOff;
+        waiter->notifying.store(true, std::memory_order_relaxed);
+    }
+
+    waiter->condVar.notify_one();
+    // The last access to the node, the waiter may destroy it right after this store
+    waiter->notifying.store(false, std::memory_order_release);
+}
+
+bool SafeMutex::enqueueNotified(WaitNode& node)
+{
+    // An ownerless mutex with the flag is being handed off (or released to barging waiters), it has an owner again
+    // soon, and that owner comes to unlockSlow because of the flag
+    auto state = m_state.load(std::memory_order_relaxed);
+    while (!(state & HAS_WAITERS_FLAG)) {
+        if (state == UNLOCKED_STATE) {
+            return false;
+        }
+
+        if (m_state.compare_exchange_weak(state, state | HAS_WAITERS_FLAG, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    node.queuedAt = WaitStart();
+    m_waiters.push(node, WaitState::Queued);
+    return true;
+}
+
+void SafeMutex::AwaitNotifier(const WaitNode& node)
+{
+    // The notifier is a couple of instructions away from the store, unless it has been preempted
+    for (std::uint32_t i = 0; node.notifying.load(std::memory_order_acquire); ++i) {
+        if (i < MIN_SPIN_LIMIT) {
+            utils::CpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SafeMutex::WaitList::push(WaitNode& node, const WaitState state)
+{
+    node.prev = tail;
+    node.next = nullptr;
+    node.state = state;
+    if (tail) {
+        tail->next = &node;
+    } else {
+        head = &node;
+    }
+    tail = &node;
+}
+
+void SafeMutex::WaitList::erase(WaitNode& node)
+{
+    (node.prev ? node.prev->next : head) = node.next;
+    (node.next ? node.next->prev : tail) = node.prev;
+    node.prev = node.next = nullptr;
+    node.state = WaitState::Idle;
+}
+
+SafeMutex::WaitNode* SafeMutex::WaitList::pop()
+{
+    auto* const node = head;
+    if (node) {
+        erase(*node);
     }
-    m_condVar.notify_one();
+    return node;
+}
+
+#if defined(ATOM_LOCK_PROFILING) || defined(ATOM_LOCK_TRACING)
+
+SafeMutex::ClockType::time_point SafeMutex::WaitStart()
+{
+    return ClockType::now();
+}
+
+void SafeMutex::onAcquire(const bool contended, const ClockType::time_point waitStart)
+{
+    const auto waitTime = contended ? ClockType::now() - waitStart : ClockType::duration::zero();
+#ifdef ATOM_LOCK_PROFILING
+    m_profile->onAcquire(contended, waitTime);
+#endif
+#ifdef ATOM_LOCK_TRACING
+    LockTracer::record(LockEventType::Acquire, m_id, waitTime);
+#endif
+}
+
+void SafeMutex::onRelease()
+{
+#ifdef ATOM_LOCK_PROFILING
+    m_profile->onRelease();
+#endif
+#ifdef ATOM_LOCK_TRACING
+    LockTracer::record(LockEventType::Release, m_id, ClockType::duration::zero());
+#endif
+}
+
+#else
+
+SafeMutex::ClockType::time_point SafeMutex::WaitStart()
+{
+    return ClockType::time_point{};
+}
+
+void SafeMutex::onAcquire(bool /*contended*/, ClockType::time_point /*waitStart*/)
+{}
+
+void SafeMutex::onRelease()
+{}
+
+#endif //! if defined(ATOM_LOCK_PROFILING) || defined(ATOM_LOCK_TRACING)
+
+std::uintptr_t SafeMutex::ToState(const LockStory* const owner)
+{
+    const auto state = reinterpret_cast<std::uintptr_t>(owner);
+    assert((state & HAS_WAITERS_FLAG) == 0);
+    return state;
+}
+
+LockStory* SafeMutex::ToOwner(const std::uintptr_t state)
+{
+    return reinterpret_cast<LockStory*>(state & ~HAS_WAITERS_FLAG);
+}
+
+void SafeMutex::checkLockOrder(const LockStory& lockStory) const
+{
+    PANIC(!lockStory.recordLockOrder(m_id));
 }
 
-#endif //! ifdef NDEBUG
+#endif //! ifdef ATOM_CHECKED_BUILD
 
 } //! namespace atom::concurrency
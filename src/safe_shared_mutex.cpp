@@ -0,0 +1,129 @@
+#include "include/concurrency/safe_shared_mutex.h"
+
+#include "include/utils/assertion.h"
+
+namespace atom::concurrency {
+
+namespace __details {
+
+DistributedSharedLock::DistributedSharedLock():
+m_readerSlots(),
+m_writer(false),
+m_writersMutex()
+{}
+
+void DistributedSharedLock::lock()
+{
+    m_writersMutex.lock();
+    m_writer.store(true);
+
+    for (auto& slot : m_readerSlots) {
+        auto readers = slot.readers.load();
+        while (readers != 0) {
+            slot.readers.wait(readers);
+            readers = slot.readers.load();
+        }
+    }
+}
+
+void DistributedSharedLock::unlock()
+{
+    m_writer.store(false);
+    m_writer.notify_all();
+    m_writersMutex.unlock();
+}
+
+void DistributedSharedLock::lockShared()
+{
+    auto& slot = m_readerSlots[CurrentReaderSlot()];
+    while (true) {
+        slot.readers.fetch_add(1);
+        if (!m_writer.load()) {
+            return;
+        }
+
+        // Step back to let the writer drain the slots
+        slot.readers.fetch_sub(1);
+        slot.readers.notify_all();
+        m_writer.wait(true);
+    }
+}
+
+void DistributedSharedLock::unlockShared()
+{
+    auto& slot = m_readerSlots[CurrentReaderSlot()];
+    // Both sides are seq_cst: either the writer sees our decrement or we see its flag and wake it up
+    slot.readers.fetch_sub(1);
+    if (m_writer.load()) {
+        slot.readers.notify_all();
+    }
+}
+
+std::size_t DistributedSharedLock::CurrentReaderSlot()
+{
+    static std::atomic<std::size_t> nextSlot{ 0 };
+    thread_local const std::size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % READER_SLOTS;
+    return slot;
+}
+
+} //! namespace __details
+
+#ifdef ATOM_CHECKED_BUILD
+
+SafeSharedMutex::SafeSharedMutex():
+m_id(__details::GenerateLockId()),
+m_lock()
+{}
+
+SafeSharedMutex::~SafeSharedMutex()
+{
+    __details::ReleaseLockId(m_id);
+}
+
+void SafeSharedMutex::lock(LockStory& lockStory)
+{
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        checkLockOrder(lockStory, LockMode::Exclusive);
+        lockStory.add(m_id, LockMode::Exclusive);
+    }
+    m_lock.lock();
+}
+
+void SafeSharedMutex::unlock(LockStory& lockStory)
+{
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        assert(lockStory.find(m_id) != nullptr && lockStory.find(m_id)->mode == LockMode::Exclusive);
+        lockStory.remove(m_id);
+    }
+    m_lock.unlock();
+}
+
+void SafeSharedMutex::lockShared(LockStory& lockStory)
+{
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        checkLockOrder(lockStory, LockMode::Shared);
+        lockStory.add(m_id, LockMode::Shared);
+    }
+    m_lock.lockShared();
+}
+
+void SafeSharedMutex::unlockShared(LockStory& lockStory)
+{
+    if (RuntimeChecks::enabled()) [[unlikely]] {
+        assert(lockStory.find(m_id) != nullptr && lockStory.find(m_id)->mode == LockMode::Shared);
+        lockStory.remove(m_id);
+    }
+    m_lock.unlockShared();
+}
+
+void SafeSharedMutex::checkLockOrder(const LockStory& lockStory, const LockMode mode) const
+{
+    const auto* const heldLock = lockStory.find(m_id);
+    // Read -> write upgrade: the writer waits for our own shared hold to drain
+    PANIC(heldLock != nullptr && heldLock->mode == LockMode::Shared && mode == LockMode::Exclusive);
+    PANIC(!lockStory.recordLockOrder(m_id));
+}
+
+#endif //! ifdef ATOM_CHECKED_BUILD
+
+} //! namespace atom::concurrency
@@ -0,0 +1,110 @@
+#include "include/concurrency/strand_sync.h"
+
+#include "include/utils/cpu_relax.h"
+
+namespace atom::concurrency::__details {
+
+StrandExecutor::StrandExecutor():
+m_head(&m_stub),
+m_tail(&m_stub),
+m_stub(),
+m_stopTask(),
+m_stopped(false),
+m_idle(false),
+m_thread()
+{
+    m_thread = std::thread{[this] { run(); }};
+}
+
+StrandExecutor::~StrandExecutor()
+{
+    // The queue is FIFO, so the executor stops after the tasks posted before
+    post(&m_stopTask);
+    m_thread.join();
+}
+
+void StrandExecutor::post(StrandTask* const task)
+{
+    push(task);
+    if (m_idle.load() && m_idle.exchange(false)) {
+        m_idle.notify_one();
+    }
+}
+
+void StrandExecutor::push(StrandTask* const task)
+{
+    task->next.store(nullptr, std::memory_order_relaxed);
+    auto* prev = m_head.exchange(task);
+    prev->next.store(task, std::memory_order_release);
+}
+
+StrandTask* StrandExecutor::pop()
+{
+    auto* tail = m_tail;
+    auto* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &m_stub) {
+        if (!next) {
+            return nullptr;
+        }
+        m_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+
+    // A producer has taken the head but has not linked its task yet
+    if (tail != m_head.load()) {
+        return nullptr;
+    }
+
+    // The tail is the last task: the stub goes behind it, so the tail can be unlinked
+    push(&m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+bool StrandExecutor::hasPending() const
+{
+    return m_tail != &m_stub || m_head.load() != &m_stub;
+}
+
+void StrandExecutor::run()
+{
+    while (!m_stopped) {
+        if (auto* task = pop()) {
+            if (task == &m_stopTask) {
+                m_stopped = true;
+            } else {
+                task->run(task);
+            }
+            continue;
+        }
+
+        auto pending = false;
+        for (std::uint32_t spins = 0; spins < SPIN_LIMIT && !pending; ++spins) {
+            utils::CpuRelax();
+            pending = hasPending();
+        }
+        if (pending) {
+            continue;
+        }
+
+        // The producers check the flag after their push: either they see it or the check below sees their task
+        m_idle.store(true);
+        if (hasPending()) {
+            m_idle.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        m_idle.wait(true);
+    }
+}
+
+} //! namespace atom::concurrency::__details
@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include "include/concurrency/owner.h"
+#include "include/concurrency/runtime_checks.h"
+#include "include/concurrency/safe_mutex.h"
+#include "include/concurrency/sync.h"
+
+#include <cstdint>
+
+// The cost of the switched off runtime checks: run the same benchmarks of a Release build and of a Release build
+// with ENABLE_RUNTIME_CHECKS and compare the /0 results, range(0) switches the checks on where they can be switched.
+//
+//      $ benchmarks --benchmark_filter=Checks
+
+using namespace atom;
+
+namespace {
+
+class ChecksScope final {
+public:
+    explicit ChecksScope([[maybe_unused]] const benchmark::State& state) {
+#if defined(NDEBUG) && defined(ATOM_RUNTIME_CHECKS)
+        concurrency::RuntimeChecks::setEnabled(state.range(0) != 0);
+#endif
+    }
+
+    ~ChecksScope() {
+#if defined(NDEBUG) && defined(ATOM_RUNTIME_CHECKS)
+        concurrency::RuntimeChecks::setEnabled(false);
+#endif
+    }
+};
+
+void BM_ChecksMutableSyncAccess(benchmark::State& state) {
+    const ChecksScope scope{ state };
+    concurrency::MutableSync<std::uint64_t> value{ std::uint64_t{ 0 } };
+
+    for (auto _ : state) {
+        value.accessMutable([](std::uint64_t& value) { benchmark::DoNotOptimize(++value); });
+        value.accessImmutable([](const std::uint64_t& value) { benchmark::DoNotOptimize(value); });
+    }
+}
+
+void BM_ChecksOwnerRef(benchmark::State& state) {
+    const ChecksScope scope{ state };
+    concurrency::Owner<std::uint64_t> owner{ std::uint64_t{ 0 } };
+
+    for (auto _ : state) {
+        auto ref = owner.getMutableRef();
+        ref.accessMutable([](std::uint64_t& value) { benchmark::DoNotOptimize(++value); });
+    }
+}
+
+void BM_ChecksSafeMutexNested(benchmark::State& state) {
+    const ChecksScope scope{ state };
+    concurrency::SafeMutex outer;
+    concurrency::SafeMutex inner;
+    concurrency::LockStory lockStory;
+    std::uint64_t value = 0;
+
+    for (auto _ : state) {
+        outer.lock(lockStory);
+        inner.lock(lockStory);
+        benchmark::DoNotOptimize(++value);
+        inner.unlock(lockStory);
+        outer.unlock(lockStory);
+    }
+}
+
+} //! namespace
+
+BENCHMARK(BM_ChecksMutableSyncAccess)->Arg(0)->Arg(1);
+BENCHMARK(BM_ChecksOwnerRef)->Arg(0)->Arg(1);
+BENCHMARK(BM_ChecksSafeMutexNested)->Arg(0)->Arg(1);
@@ -0,0 +1,154 @@
+#include <benchmark/benchmark.h>
+
+#include "include/concurrency/safe_mutex.h"
+#include "include/concurrency/recursive_safe_mutex.h"
+#include "include/concurrency/queue_lock.h"
+
+#include <memory>
+#include <mutex>
+
+using namespace atom;
+
+namespace {
+
+void BM_StdMutexUncontended(benchmark::State& state) {
+    std::mutex mutex;
+    std::uint64_t value = 0;
+
+    for (auto _ : state) {
+        mutex.lock();
+        benchmark::DoNotOptimize(++value);
+        mutex.unlock();
+    }
+}
+
+void BM_SafeMutexUncontended(benchmark::State& state) {
+    concurrency::SafeMutex mutex;
+    concurrency::LockStory lockStory;
+    std::uint64_t value = 0;
+
+    for (auto _ : state) {
+        mutex.lock(lockStory);
+        benchmark::DoNotOptimize(++value);
+        mutex.unlock(lockStory);
+    }
+}
+
+void BM_SafeMutexUncontendedImplicitStory(benchmark::State& state) {
+    concurrency::SafeMutex mutex;
+    std::uint64_t value = 0;
+
+    for (auto _ : state) {
+        std::lock_guard lock{ mutex };
+        benchmark::DoNotOptimize(++value);
+    }
+}
+
+// Release builds check 1 in range(0) acquisitions, 0 means the sampler is off
+void BM_SafeMutexUncontendedNestedSampled(benchmark::State& state) {
+    concurrency::LockSampler::setInterval(static_cast<std::uint32_t>(state.range(0)));
+    concurrency::SafeMutex outer;
+    concurrency::SafeMutex inner;
+    std::uint64_t value = 0;
+
+    for (auto _ : state) {
+        outer.lock();
+        inner.lock();
+        benchmark::DoNotOptimize(++value);
+        inner.unlock();
+        outer.unlock();
+    }
+    concurrency::LockSampler::setInterval(0);
+}
+
+void BM_SafeMutexUncontendedNested(benchmark::State& state) {
+    concurrency::SafeMutex outer;
+    concurrency::SafeMutex inner;
+    concurrency::LockStory lockStory;
+    std::uint64_t value = 0;
+
+    for (auto _ : state) {
+        outer.lock(lockStory);
+        inner.lock(lockStory);
+        benchmark::DoNotOptimize(++value);
+        inner.unlock(lockStory);
+        outer.unlock(lockStory);
+    }
+}
+
+void BM_RecursiveSafeMutexReentry(benchmark::State& state) {
+    concurrency::RecursiveSafeMutex mutex;
+    concurrency::LockStory lockStory;
+    std::uint64_t value = 0;
+
+    mutex.lock(lockStory);
+    for (auto _ : state) {
+        mutex.lock(lockStory);
+        benchmark::DoNotOptimize(++value);
+        mutex.unlock(lockStory);
+    }
+    mutex.unlock(lockStory);
+}
+
+template<typename Mutex>
+void ContendedIncrement(benchmark::State& state, Mutex& mutex, std::uint64_t& value) {
+    for (auto _ : state) {
+        std::lock_guard lock{ mutex };
+        benchmark::DoNotOptimize(++value);
+    }
+}
+
+// Building and destroying many locks which are never ordered against each other stays linear
+void BM_SafeMutexConstructDestroy(benchmark::State& state) {
+    for (auto _ : state) {
+        auto mutexes = std::make_unique<concurrency::SafeMutex[]>(state.range(0));
+        benchmark::DoNotOptimize(mutexes.get());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_StdMutexContended(benchmark::State& state) {
+    static std::mutex mutex;
+    static std::uint64_t value = 0;
+    ContendedIncrement(state, mutex, value);
+}
+
+void BM_SafeMutexContendedFifo(benchmark::State& state) {
+    static concurrency::SafeMutex mutex{ concurrency::WaitPolicy::Fifo };
+    static std::uint64_t value = 0;
+    ContendedIncrement(state, mutex, value);
+}
+
+void BM_SafeMutexContendedBarging(benchmark::State& state) {
+    static concurrency::SafeMutex mutex{ concurrency::WaitPolicy::Barging };
+    static std::uint64_t value = 0;
+    ContendedIncrement(state, mutex, value);
+}
+
+void BM_McsLockContended(benchmark::State& state) {
+    static concurrency::McsLock mutex;
+    static std::uint64_t value = 0;
+    ContendedIncrement(state, mutex, value);
+}
+
+void BM_ClhLockContended(benchmark::State& state) {
+    static concurrency::ClhLock mutex;
+    static std::uint64_t value = 0;
+    ContendedIncrement(state, mutex, value);
+}
+
+} //! namespace
+
+BENCHMARK(BM_StdMutexUncontended);
+BENCHMARK(BM_SafeMutexUncontended);
+BENCHMARK(BM_SafeMutexUncontendedImplicitStory);
+BENCHMARK(BM_SafeMutexUncontendedNested);
+BENCHMARK(BM_RecursiveSafeMutexReentry);
+BENCHMARK(BM_SafeMutexUncontendedNestedSampled)->Arg(0)->Arg(1)->Arg(100)->Arg(1000);
+BENCHMARK(BM_SafeMutexConstructDestroy)->Arg(1000)->Arg(50000);
+
+BENCHMARK(BM_StdMutexContended)->Threads(2)->Threads(8)->Threads(32)->UseRealTime();
+BENCHMARK(BM_SafeMutexContendedFifo)->Threads(2)->Threads(8)->Threads(32)->UseRealTime();
+BENCHMARK(BM_SafeMutexContendedBarging)->Threads(2)->Threads(8)->Threads(32)->UseRealTime();
+BENCHMARK(BM_McsLockContended)->Threads(2)->Threads(8)->Threads(32)->Threads(64)->UseRealTime();
+BENCHMARK(BM_ClhLockContended)->Threads(2)->Threads(8)->Threads(32)->Threads(64)->UseRealTime();
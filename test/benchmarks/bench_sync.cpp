@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include "include/concurrency/combining_sync.h"
+#include "include/concurrency/rcu_sync.h"
+#include "include/concurrency/seqlock_sync.h"
+#include "include/concurrency/strand_sync.h"
+#include "include/concurrency/sync.h"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+using namespace atom;
+
+namespace {
+
+struct Quote final {
+    std::int64_t bid;
+    std::int64_t ask;
+};
+
+// Readers don't write the shared line, the time per read stays flat as threads are added
+void BM_SeqlockSyncRead(benchmark::State& state) {
+    static concurrency::SeqlockSync<Quote> quote{ Quote{ 100, 101 } };
+
+    for (auto _ : state) {
+        quote.accessImmutable([](const Quote& quote) { benchmark::DoNotOptimize(quote.ask - quote.bid); });
+    }
+}
+
+// One thread writes, the rest read
+void BM_SeqlockSyncReadWithWriter(benchmark::State& state) {
+    static concurrency::SeqlockSync<Quote> quote{ Quote{ 100, 101 } };
+
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            quote.accessMutable([](Quote& quote) { ++quote.bid; ++quote.ask; });
+        } else {
+            benchmark::DoNotOptimize(quote.getValue());
+        }
+    }
+}
+
+void BM_MutableSyncRead(benchmark::State& state) {
+    concurrency::MutableSync<Quote> quote{ Quote{ 100, 101 } };
+
+    for (auto _ : state) {
+        quote.accessImmutable([](const Quote& quote) { benchmark::DoNotOptimize(quote.ask - quote.bid); });
+    }
+}
+
+// A read pins the current version without copying it, however large the value is
+void BM_RcuSyncRead(benchmark::State& state) {
+    static concurrency::RcuSync<std::vector<std::uint64_t>> table{ std::size_t{ 4096 }, std::uint64_t{ 1 } };
+
+    for (auto _ : state) {
+        const auto snapshot = table.read();
+        benchmark::DoNotOptimize((*snapshot)[state.iterations() % 4096]);
+    }
+}
+
+// Many threads push to one queue: the combiner applies the batch while the deque stays in its cache
+void BM_CombiningSyncPush(benchmark::State& state) {
+    static concurrency::CombiningSync<std::deque<std::uint64_t>> queue;
+
+    for (auto _ : state) {
+        queue.accessMutable([](std::deque<std::uint64_t>& queue) {
+            queue.push_back(queue.size());
+            if (queue.size() > 1024) {
+                queue.pop_front();
+            }
+        });
+    }
+}
+
+// The producers only enqueue, the deque is touched by the executor thread alone
+void BM_StrandSyncPush(benchmark::State& state) {
+    static concurrency::StrandSync<std::deque<std::uint64_t>> queue;
+
+    for (auto _ : state) {
+        queue.post([](std::deque<std::uint64_t>& queue) {
+            queue.push_back(queue.size());
+            if (queue.size() > 1024) {
+                queue.pop_front();
+            }
+        });
+    }
+}
+
+void BM_StdMutexPush(benchmark::State& state) {
+    static std::mutex mutex;
+    static std::deque<std::uint64_t> queue;
+
+    for (auto _ : state) {
+        std::lock_guard lock{ mutex };
+        queue.push_back(queue.size());
+        if (queue.size() > 1024) {
+            queue.pop_front();
+        }
+    }
+}
+
+} //! namespace
+
+BENCHMARK(BM_MutableSyncRead);
+BENCHMARK(BM_SeqlockSyncRead)->Threads(1)->Threads(2)->Threads(8)->UseRealTime();
+BENCHMARK(BM_SeqlockSyncReadWithWriter)->Threads(2)->Threads(8)->UseRealTime();
+BENCHMARK(BM_RcuSyncRead)->Threads(1)->Threads(2)->Threads(8)->UseRealTime();
+BENCHMARK(BM_CombiningSyncPush)->Threads(1)->Threads(2)->Threads(8)->Threads(32)->UseRealTime();
+BENCHMARK(BM_StrandSyncPush)->Threads(1)->Threads(2)->Threads(8)->Threads(32)->UseRealTime();
+BENCHMARK(BM_StdMutexPush)->Threads(1)->Threads(2)->Threads(8)->Threads(32)->UseRealTime();
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/async_safe_mutex.h"
+
+#include <atomic>
+#include <coroutine>
+#include <thread>
+#include <vector>
+
+using namespace atom;
+using AsyncSafeMutex = concurrency::AsyncSafeMutex;
+
+namespace {
+
+// Eagerly started coroutine which destroys itself when it finishes
+struct DetachedTask final {
+    struct promise_type final {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// Suspends the awaiting coroutine until set() resumes it
+class Event final {
+public:
+    bool await_ready() const { return false; }
+    void await_suspend(const std::coroutine_handle<> handle) { m_handle = handle; }
+    void await_resume() const {}
+
+    void set() { std::exchange(m_handle, nullptr).resume(); }
+
+private:
+    std::coroutine_handle<> m_handle;
+};
+
+DetachedTask HoldUntil(AsyncSafeMutex& mutex, concurrency::LockStory& lockStory, Event& event, std::vector<int>& trace,
+    const int step) {
+    co_await mutex.lock(lockStory);
+    trace.push_back(step);
+    co_await event;
+    mutex.unlock(lockStory);
+}
+
+DetachedTask Append(AsyncSafeMutex& mutex, concurrency::LockStory& lockStory, std::vector<int>& trace, const int step) {
+    const auto guard = co_await mutex.scopedLock(lockStory);
+    trace.push_back(step);
+}
+
+DetachedTask Increment(AsyncSafeMutex& mutex, std::uint64_t& counter, std::atomic<int>& done) {
+    concurrency::LockStory lockStory;
+    {
+        const auto guard = co_await mutex.scopedLock(lockStory);
+        ++counter;
+    }
+    done.fetch_add(1, std::memory_order_relaxed);
+}
+
+} //! namespace
+
+TEST(TestAsyncSafeMutex, TestWaitersSuspendAndResumeInOrder) {
+    AsyncSafeMutex mutex;
+    concurrency::LockStory first, second, third;
+    Event event;
+    std::vector<int> trace;
+
+    HoldUntil(mutex, first, event, trace, 1);
+    // Both waiters suspend, the thread goes on
+    Append(mutex, second, trace, 2);
+    Append(mutex, third, trace, 3);
+    EXPECT_EQ(trace, std::vector<int>{ 1 });
+    EXPECT_TRUE(mutex.tryLock(second).isError());
+
+    event.set();
+    EXPECT_EQ(trace, (std::vector<int>{ 1, 2, 3 }));
+    EXPECT_TRUE(mutex.tryLock(first).isOk());
+    mutex.unlock(first);
+}
+
+TEST(TestAsyncSafeMutex, TestLongChainOfWaitersDoesNotNest) {
+    AsyncSafeMutex mutex;
+    concurrency::LockStory holder;
+    Event event;
+    std::vector<int> trace;
+    constexpr auto waitersCount = 100'000;
+
+    HoldUntil(mutex, holder, event, trace, 0);
+    std::vector<concurrency::LockStory> lockStories(waitersCount);
+    for (auto i = 0; i < waitersCount; ++i) {
+        Append(mutex, lockStories[i], trace, i + 1);
+    }
+
+    // Every waiter unlocks right away, resumed one inside another they would overflow the stack
+    event.set();
+    ASSERT_EQ(trace.size(), waitersCount + 1);
+    for (auto i = 0; i <= waitersCount; ++i) {
+        EXPECT_EQ(trace[i], i);
+    }
+    EXPECT_TRUE(mutex.tryLock(holder).isOk());
+    mutex.unlock(holder);
+}
+
+TEST(TestAsyncSafeMutex, TestCounter) {
+    AsyncSafeMutex mutex;
+    std::uint64_t counter = 0;
+    std::atomic<int> done{ 0 };
+    constexpr auto threadsCount = 4;
+    constexpr auto tasksCount = 10'000;
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&] {
+            for (auto j = 0; j < tasksCount; ++j) {
+                Increment(mutex, counter, done);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(done.load(), threadsCount * tasksCount);
+    EXPECT_EQ(counter, threadsCount * tasksCount);
+}
+
+#ifndef NDEBUG
+
+TEST(TestAsyncSafeMutex, TestLockStoryPerTask) {
+    AsyncSafeMutex mutex;
+    concurrency::LockStory lockStory;
+
+    ASSERT_TRUE(mutex.tryLock(lockStory).isOk());
+    EXPECT_EQ(lockStory.size(), 1);
+    const auto result = mutex.tryLock(lockStory);
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.error(), concurrency::LockError::Deadlock);
+    mutex.unlock(lockStory);
+    EXPECT_TRUE(lockStory.empty());
+}
+
+TEST(TestAsyncSafeMutex, TestLockOrderAcrossTasks) {
+    AsyncSafeMutex m1;
+    AsyncSafeMutex m2;
+
+    const auto lockBoth = [](AsyncSafeMutex& first, AsyncSafeMutex& second) -> DetachedTask {
+        concurrency::LockStory lockStory;
+        const auto firstGuard = co_await first.scopedLock(lockStory);
+        const auto secondGuard = co_await second.scopedLock(lockStory);
+    };
+
+    // Two tasks on one thread, the inversion is found by their stories, not by the thread
+    lockBoth(m1, m2);
+    EXPECT_DEATH(lockBoth(m2, m1), "PANIC");
+}
+
+#endif //! ifndef NDEBUG
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/combining_sync.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace atom;
+
+TEST(TestCombiningSync, TestAccess) {
+    concurrency::CombiningSync<std::vector<int>> values{ std::vector<int>{ 1, 2 } };
+
+    values.accessMutable([](std::vector<int>& values) { values.push_back(3); });
+    EXPECT_EQ(values.accessImmutable([](const std::vector<int>& values) { return values.size(); }), 3);
+
+    values.setValue(std::vector<int>{ 4 });
+    EXPECT_EQ(values.getValue(), std::vector<int>{ 4 });
+}
+
+TEST(TestCombiningSync, TestConstAccess) {
+    concurrency::CombiningSync<std::uint64_t> counter{ std::uint64_t{ 0 } };
+    const auto& view = counter;
+    constexpr auto iterations = 5'000;
+
+    std::thread writer([&counter] {
+        for (auto i = 0; i < iterations; ++i) {
+            counter.accessMutable([](std::uint64_t& value) { ++value; });
+        }
+    });
+
+    // The readers go through the combiner as well, so they see the updates in order
+    std::uint64_t last = 0;
+    for (auto i = 0; i < iterations; ++i) {
+        const auto current = view.accessImmutable([](const std::uint64_t& value) { return value; });
+        EXPECT_GE(current, last);
+        last = current;
+    }
+    writer.join();
+    EXPECT_EQ(view.getValue(), iterations);
+}
+
+TEST(TestCombiningSync, TestEveryCallerGetsItsResult) {
+    concurrency::CombiningSync<std::uint64_t> counter{ std::uint64_t{ 0 } };
+    constexpr auto threadsCount = 8;
+    constexpr auto iterations = 5'000;
+
+    std::vector<std::vector<std::uint64_t>> tickets(threadsCount);
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&counter, &tickets, i] {
+            for (auto j = 0; j < iterations; ++j) {
+                tickets[i].push_back(counter.accessMutable([](std::uint64_t& value) { return value++; }));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Fetch-and-increment hands out every ticket exactly once
+    std::vector<std::uint64_t> all;
+    for (const auto& thread : tickets) {
+        EXPECT_TRUE(std::is_sorted(thread.cbegin(), thread.cend()));
+        all.insert(all.end(), thread.cbegin(), thread.cend());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), threadsCount * iterations);
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        ASSERT_EQ(all[i], i);
+    }
+    EXPECT_EQ(counter.getValue(), threadsCount * iterations);
+}
+
+TEST(TestCombiningSync, TestExceptionGoesToCaller) {
+    concurrency::CombiningSync<int> value{ 0 };
+
+    EXPECT_THROW(value.accessMutable([](int& ) { throw std::runtime_error("failed"); }), std::runtime_error);
+    value.accessMutable([](int& value) { ++value; });
+    EXPECT_EQ(value.getValue(), 1);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/epoch_domain.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace atom;
+using EpochDomain = concurrency::EpochDomain;
+
+namespace {
+
+std::atomic<int> deleted{ 0 };
+
+void CountDeleted(void* ) {
+    deleted.fetch_add(1);
+}
+
+int dummy = 0;
+
+} //! namespace
+
+TEST(TestEpochDomain, TestSynchronizeDeletesRetired) {
+    EpochDomain domain;
+    deleted = 0;
+
+    {
+        EpochDomain::Guard guard{ domain };
+        domain.retire(&dummy, &CountDeleted);
+        domain.retire(&dummy, &CountDeleted);
+        // The reader which is inside the domain could still see them
+        EXPECT_EQ(domain.reclaim(), 0);
+    }
+
+    domain.synchronize();
+    EXPECT_EQ(deleted.load(), 2);
+    EXPECT_EQ(domain.retiredCount(), 0);
+}
+
+TEST(TestEpochDomain, TestReaderHoldsBackReclamation) {
+    EpochDomain domain;
+    deleted = 0;
+    std::atomic<bool> entered{ false };
+    std::atomic<bool> leave{ false };
+
+    std::thread reader{[&] {
+        EpochDomain::Guard guard{ domain };
+        {
+            EpochDomain::Guard nested{ domain };
+        }
+        entered = true;
+        while (!leave) {
+            std::this_thread::yield();
+        }
+    }};
+    while (!entered) {
+        std::this_thread::yield();
+    }
+
+    domain.retire(&dummy, &CountDeleted);
+    for (auto i = 0; i < 10; ++i) {
+        EXPECT_EQ(domain.reclaim(), 0);
+    }
+    EXPECT_EQ(deleted.load(), 0);
+
+    leave = true;
+    reader.join();
+    domain.synchronize();
+    EXPECT_EQ(deleted.load(), 1);
+}
+
+TEST(TestEpochDomain, TestEpochAdvancesWithoutReaders) {
+    EpochDomain domain;
+    const auto epoch = domain.epoch();
+
+    domain.reclaim();
+    domain.reclaim();
+    EXPECT_EQ(domain.epoch(), epoch + 2);
+}
+
+TEST(TestEpochDomain, TestSynchronizeInsideGuard) {
+    EpochDomain domain;
+
+    const auto synchronizeInside = [&domain] {
+        EpochDomain::Guard guard{ domain };
+        domain.synchronize();
+    };
+    EXPECT_DEATH(synchronizeInside(), "PANIC");
+}
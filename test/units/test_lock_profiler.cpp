@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/lock_profiler.h"
+#include "include/concurrency/safe_condition_variable.h"
+#include "include/concurrency/safe_mutex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+using namespace atom;
+using namespace std::chrono_literals;
+using LockProfile = concurrency::LockProfile;
+
+namespace {
+
+const concurrency::LockProfileSnapshot* FindSnapshot(const std::vector<concurrency::LockProfileSnapshot>& snapshots,
+    const std::string_view name)
+{
+    const auto it = std::find_if(snapshots.cbegin(), snapshots.cend(), [name](const auto& snapshot) {
+        return snapshot.name == name;
+    });
+    return it != snapshots.cend() ? &(*it) : nullptr;
+}
+
+} //! namespace
+
+TEST(TestLockProfiler, TestBucketOf) {
+    EXPECT_EQ(LockProfile::BucketOf(0ns), 0);
+    EXPECT_EQ(LockProfile::BucketOf(1ns), 1);
+    EXPECT_EQ(LockProfile::BucketOf(3ns), 2);
+    EXPECT_EQ(LockProfile::BucketOf(1024ns), 11);
+    EXPECT_EQ(LockProfile::BucketOf(1000h), LockProfile::BUCKETS - 1);
+}
+
+TEST(TestLockProfiler, TestProfileCounters) {
+    LockProfile profile("test-profile-counters");
+
+    profile.onAcquire(false, 0ns);
+    profile.onRelease();
+    profile.onAcquire(true, 100ns);
+    profile.onRelease();
+
+    const auto snapshot = profile.snapshot();
+    EXPECT_EQ(snapshot.acquisitions, 2);
+    EXPECT_EQ(snapshot.contended, 1);
+    EXPECT_EQ(snapshot.totalWait, 100ns);
+    EXPECT_EQ(snapshot.waitHistogram[0], 1);
+    EXPECT_EQ(snapshot.waitHistogram[LockProfile::BucketOf(100ns)], 1);
+
+    profile.reset();
+    EXPECT_EQ(profile.snapshot().acquisitions, 0);
+}
+
+TEST(TestLockProfiler, TestReportIsSortedByWaitTime) {
+    LockProfile cold("test-profile-cold");
+    LockProfile hot("test-profile-hot");
+
+    cold.onAcquire(true, 10ns);
+    cold.onRelease();
+    hot.onAcquire(true, 10ms);
+    hot.onRelease();
+
+    const auto snapshots = concurrency::LockProfiler::instance().snapshot();
+    const auto* hotSnapshot = FindSnapshot(snapshots, "test-profile-hot");
+    const auto* coldSnapshot = FindSnapshot(snapshots, "test-profile-cold");
+    ASSERT_NE(hotSnapshot, nullptr);
+    ASSERT_NE(coldSnapshot, nullptr);
+    EXPECT_LT(hotSnapshot, coldSnapshot);
+
+    std::stringstream report;
+    concurrency::LockProfiler::instance().report(report);
+    EXPECT_LT(report.str().find("test-profile-hot"), report.str().find("test-profile-cold"));
+}
+
+#ifdef ATOM_LOCK_PROFILING
+
+TEST(TestLockProfiler, TestSafeMutexIsProfiled) {
+    concurrency::SafeMutex mutex("test-profiled-safe-mutex");
+    concurrency::LockStory lockStory;
+
+    mutex.lock(lockStory);
+    std::thread waiter{[&mutex] {
+        std::lock_guard lock{ mutex };
+    }};
+    std::this_thread::sleep_for(1ms);
+    mutex.unlock(lockStory);
+    waiter.join();
+
+    const auto snapshots = concurrency::LockProfiler::instance().snapshot();
+    const auto* snapshot = FindSnapshot(snapshots, "test-profiled-safe-mutex");
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->acquisitions, 2);
+    EXPECT_LE(snapshot->contended, 1);
+}
+
+#ifdef ATOM_CHECKED_BUILD
+
+TEST(TestLockProfiler, TestMorphedConditionWaiterIsContended) {
+    concurrency::SafeMutex mutex("test-morphed-condition-waiter");
+    concurrency::SafeConditionVariable condVar;
+    std::atomic<bool> waiting = false;
+    auto notified = false;
+
+    std::thread waiter{[&] {
+        auto& lockStory = concurrency::LockStory::current();
+        mutex.lock(lockStory);
+        waiting = true;
+        condVar.wait(mutex, lockStory, [&notified] { return notified; });
+        mutex.unlock(lockStory);
+    }};
+
+    while (!waiting.load()) {
+        std::this_thread::yield();
+    }
+    {
+        // The waiter is queued on the held mutex by the notification and waits for it until the unlock
+        std::lock_guard lock{ mutex };
+        notified = true;
+        condVar.notifyOne();
+        std::this_thread::sleep_for(1ms);
+    }
+    waiter.join();
+
+    const auto snapshots = concurrency::LockProfiler::instance().snapshot();
+    const auto* snapshot = FindSnapshot(snapshots, "test-morphed-condition-waiter");
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->acquisitions, 3);
+    EXPECT_EQ(snapshot->contended, 1);
+    EXPECT_GE(snapshot->totalWait, 1ms);
+}
+
+#endif //! ifdef ATOM_CHECKED_BUILD
+
+#endif //! ifdef ATOM_LOCK_PROFILING
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/lock_sampler.h"
+#include "include/concurrency/lock_order_graph.h"
+#include "include/concurrency/safe_mutex.h"
+
+#include <cstdint>
+#include <span>
+
+using namespace atom;
+using LockSampler = concurrency::LockSampler;
+
+namespace {
+
+void IgnoreViolation(std::span<const std::uint32_t> , std::uint32_t ) {}
+
+class SamplingScope final {
+public:
+    explicit SamplingScope(const std::uint32_t interval) {
+        LockSampler::setInterval(interval);
+        LockSampler::setReportHandler(&IgnoreViolation);
+    }
+
+    ~SamplingScope() {
+        LockSampler::setInterval(0);
+        LockSampler::setReportHandler(nullptr);
+    }
+};
+
+void LockInOrder(const std::uint32_t first, const std::uint32_t second) {
+    LockSampler::onAcquiring(first);
+    LockSampler::onAcquiring(second);
+    LockSampler::onReleased(second);
+    LockSampler::onReleased(first);
+}
+
+} //! namespace
+
+TEST(TestLockSampler, TestEveryAcquisitionIsSampled) {
+    auto& graph = concurrency::LockOrderGraph::instance();
+    const auto m1 = concurrency::__details::GenerateLockId();
+    const auto m2 = concurrency::__details::GenerateLockId();
+    {
+        SamplingScope scope{ 1 };
+        const auto violations = LockSampler::violations();
+
+        LockInOrder(m1, m2);
+        EXPECT_TRUE(graph.hasEdge(m1, m2));
+        EXPECT_EQ(LockSampler::violations(), violations);
+
+        LockInOrder(m2, m1);
+        EXPECT_EQ(LockSampler::violations(), violations + 1);
+        EXPECT_FALSE(graph.hasEdge(m2, m1));
+    }
+
+    concurrency::__details::ReleaseLockId(m1);
+    concurrency::__details::ReleaseLockId(m2);
+}
+
+TEST(TestLockSampler, TestDisabledSamplerRecordsNothing) {
+    auto& graph = concurrency::LockOrderGraph::instance();
+    const auto m1 = concurrency::__details::GenerateLockId();
+    const auto m2 = concurrency::__details::GenerateLockId();
+
+    LockInOrder(m1, m2);
+    EXPECT_FALSE(graph.hasEdge(m1, m2));
+
+    concurrency::__details::ReleaseLockId(m1);
+    concurrency::__details::ReleaseLockId(m2);
+}
+
+TEST(TestLockSampler, TestSampledEdgesConverge) {
+    auto& graph = concurrency::LockOrderGraph::instance();
+    const auto m1 = concurrency::__details::GenerateLockId();
+    const auto m2 = concurrency::__details::GenerateLockId();
+    {
+        // The second acquisition is sampled sooner or later
+        SamplingScope scope{ 8 };
+        for (auto i = 0; i < 1000 && !graph.hasEdge(m1, m2); ++i) {
+            LockInOrder(m1, m2);
+        }
+        EXPECT_TRUE(graph.hasEdge(m1, m2));
+    }
+
+    concurrency::__details::ReleaseLockId(m1);
+    concurrency::__details::ReleaseLockId(m2);
+}
+
+#ifndef ATOM_CHECKED_BUILD
+
+TEST(TestLockSampler, TestReleaseSafeMutexReportsInversion) {
+    SamplingScope scope{ 1 };
+    concurrency::SafeMutex m1, m2;
+    const auto violations = LockSampler::violations();
+
+    m1.lock();
+    m2.lock();
+    m2.unlock();
+    m1.unlock();
+
+    // Reported, but the release build doesn't abort
+    m2.lock();
+    m1.lock();
+    m1.unlock();
+    m2.unlock();
+    EXPECT_EQ(LockSampler::violations(), violations + 1);
+}
+
+#endif //! ifndef ATOM_CHECKED_BUILD
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/lock_tracer.h"
+#include "include/concurrency/safe_mutex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace atom;
+using namespace std::chrono_literals;
+using LockTracer = concurrency::LockTracer;
+using LockEvent = concurrency::LockEvent;
+using LockEventType = concurrency::LockEventType;
+
+namespace {
+
+std::string TracePath() {
+    return (std::filesystem::temp_directory_path() / "atom_test.locktrace").string();
+}
+
+std::pair<concurrency::LockTraceHeader, std::vector<LockEvent>> ReadTrace(const std::string& path) {
+    std::ifstream file{ path, std::ios::binary };
+    concurrency::LockTraceHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    std::vector<LockEvent> events(std::min(header.size, header.capacity));
+    file.read(reinterpret_cast<char*>(events.data()), static_cast<std::streamsize>(events.size() * sizeof(LockEvent)));
+    return { header, events };
+}
+
+} //! namespace
+
+TEST(TestLockTracer, TestRecordsEventsOfAllThreads) {
+    const auto path = TracePath();
+    ASSERT_TRUE(LockTracer::start(path));
+    EXPECT_FALSE(LockTracer::start(path));
+
+    // More events than a ring holds, so the thread drains its ring on its own as well
+    constexpr auto eventsPerThread = 3000;
+    std::vector<std::thread> threads;
+    for (std::uint32_t mutexId = 0; mutexId < 2; ++mutexId) {
+        threads.emplace_back([mutexId] {
+            for (auto i = 0; i < eventsPerThread; ++i) {
+                LockTracer::record(LockEventType::Acquire, mutexId, 5ns);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    LockTracer::record(LockEventType::Release, 7, 0ns);
+    LockTracer::stop();
+    EXPECT_FALSE(LockTracer::isActive());
+
+    const auto [header, events] = ReadTrace(path);
+    EXPECT_EQ(header.magic, concurrency::LockTraceHeader::MAGIC);
+    EXPECT_EQ(header.size, 2 * eventsPerThread + 1);
+    ASSERT_EQ(events.size(), 2 * eventsPerThread + 1);
+    EXPECT_EQ(std::filesystem::file_size(path), sizeof(header) + events.size() * sizeof(LockEvent));
+
+    for (std::uint32_t mutexId = 0; mutexId < 2; ++mutexId) {
+        const auto count = std::count_if(events.cbegin(), events.cend(), [mutexId](const LockEvent& event) {
+            return event.mutexId == mutexId && event.type == LockEventType::Acquire && event.waitTime == 5;
+        });
+        EXPECT_EQ(count, eventsPerThread);
+    }
+    EXPECT_EQ(std::count_if(events.cbegin(), events.cend(), [](const LockEvent& event) {
+        return event.mutexId == 7 && event.type == LockEventType::Release;
+    }), 1);
+
+    std::filesystem::remove(path);
+}
+
+TEST(TestLockTracer, TestDropsEventsBeyondCapacity) {
+    const auto path = TracePath();
+    ASSERT_TRUE(LockTracer::start(path, 10));
+    for (auto i = 0; i < 25; ++i) {
+        LockTracer::record(LockEventType::Acquire, 1, 0ns);
+    }
+    LockTracer::stop();
+
+    const auto [header, events] = ReadTrace(path);
+    EXPECT_EQ(header.capacity, 10);
+    EXPECT_EQ(header.size, 25);
+    EXPECT_EQ(events.size(), 10);
+
+    std::filesystem::remove(path);
+}
+
+TEST(TestLockTracer, TestRecordsNothingWhenStopped) {
+    const auto path = TracePath();
+    LockTracer::record(LockEventType::Acquire, 1, 0ns);
+    ASSERT_TRUE(LockTracer::start(path));
+    LockTracer::stop();
+
+    const auto [header, events] = ReadTrace(path);
+    EXPECT_EQ(header.size, 0);
+
+    std::filesystem::remove(path);
+}
+
+#ifdef ATOM_LOCK_TRACING
+
+TEST(TestLockTracer, TestSafeMutexEvents) {
+    const auto path = TracePath();
+    concurrency::SafeMutex mutex;
+    ASSERT_TRUE(LockTracer::start(path));
+    mutex.lock();
+    mutex.unlock();
+    LockTracer::stop();
+
+    const auto [header, events] = ReadTrace(path);
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0].mutexId, mutex.id());
+    EXPECT_EQ(events[0].type, LockEventType::Acquire);
+    EXPECT_EQ(events[1].type, LockEventType::Release);
+
+    std::filesystem::remove(path);
+}
+
+#endif //! ifdef ATOM_LOCK_TRACING
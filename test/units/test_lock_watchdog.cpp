@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/lock_watchdog.h"
+#include "include/concurrency/safe_mutex.h"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace atom;
+using LockWatchdog = concurrency::LockWatchdog;
+
+namespace {
+
+std::mutex reportMutex;
+std::string lastReport;
+
+void CaptureReport(const std::string_view report) {
+    std::lock_guard lock{ reportMutex };
+    lastReport = report;
+}
+
+class WatchdogScope final {
+public:
+    explicit WatchdogScope() {
+        lastReport.clear();
+        LockWatchdog::setReportHandler(&CaptureReport);
+        LockWatchdog::start(std::chrono::milliseconds(20));
+    }
+
+    ~WatchdogScope() {
+        LockWatchdog::stop();
+        LockWatchdog::setReportHandler(nullptr);
+    }
+};
+
+std::string WaitForReport(const std::uint64_t reports) {
+    for (auto i = 0; i < 500 && LockWatchdog::reports() == reports; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    std::lock_guard lock{ reportMutex };
+    return lastReport;
+}
+
+} //! namespace
+
+TEST(TestLockWatchdog, TestReportsExternalWait) {
+    WatchdogScope scope;
+    const auto reports = LockWatchdog::reports();
+    EXPECT_FALSE(LockWatchdog::start(std::chrono::milliseconds(20)));
+
+    std::thread waiter{[] {
+        const LockWatchdog::WaitGuard wait{ concurrency::LockStory::current(), "socket read" };
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }};
+
+    const auto report = WaitForReport(reports);
+    waiter.join();
+    EXPECT_NE(report.find("\"socket read\""), std::string::npos);
+    EXPECT_EQ(report.find("deadlock"), std::string::npos);
+}
+
+TEST(TestLockWatchdog, TestNoReportWhenStopped) {
+    const auto reports = LockWatchdog::reports();
+    {
+        const LockWatchdog::WaitGuard wait{ concurrency::LockStory::current(), "socket read" };
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+    EXPECT_EQ(LockWatchdog::reports(), reports);
+}
+
+#ifndef NDEBUG
+
+TEST(TestLockWatchdog, TestReportsDeadlockThroughExternalWaits) {
+    WatchdogScope scope;
+    const auto reports = LockWatchdog::reports();
+    concurrency::SafeMutex m1;
+    concurrency::SafeMutex m2;
+
+    // Each thread holds one mutex and waits for the other one outside of SafeMutex, the inline check can't see it
+    const auto waitFor = [](concurrency::SafeMutex& held, const concurrency::SafeMutex& awaited) {
+        auto& lockStory = concurrency::LockStory::current();
+        held.lock(lockStory);
+        {
+            const LockWatchdog::WaitGuard wait{ lockStory, awaited.id() };
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        held.unlock(lockStory);
+    };
+    std::thread first{ waitFor, std::ref(m1), std::cref(m2) };
+    std::thread second{ waitFor, std::ref(m2), std::cref(m1) };
+
+    const auto report = WaitForReport(reports);
+    first.join();
+    second.join();
+    EXPECT_NE(report.find("deadlock"), std::string::npos);
+    EXPECT_NE(report.find("lock #" + std::to_string(m1.id())), std::string::npos);
+    EXPECT_NE(report.find("lock #" + std::to_string(m2.id())), std::string::npos);
+}
+
+TEST(TestLockWatchdog, TestReportsParkedSafeMutexWaiter) {
+    WatchdogScope scope;
+    const auto reports = LockWatchdog::reports();
+    concurrency::SafeMutex mutex;
+
+    std::unique_lock lock{ mutex };
+    std::thread waiter{[&mutex] {
+        std::lock_guard lock{ mutex };
+    }};
+
+    const auto report = WaitForReport(reports);
+    lock.unlock();
+    waiter.join();
+    EXPECT_NE(report.find("for lock #" + std::to_string(mutex.id())), std::string::npos);
+}
+
+#endif //! ifndef NDEBUG
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/queue_lock.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace atom;
+
+namespace {
+
+template<typename Lock>
+class TestQueueLock : public ::testing::Test {};
+
+using QueueLockTypes = ::testing::Types<concurrency::McsLock, concurrency::ClhLock>;
+
+} //! namespace
+
+TYPED_TEST_SUITE(TestQueueLock, QueueLockTypes);
+
+TYPED_TEST(TestQueueLock, TestCounter) {
+    TypeParam lock;
+    std::uint64_t counter = 0;
+    constexpr auto threadsCount = 8;
+    constexpr auto iterations = 10'000;
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&] {
+            auto& lockStory = concurrency::LockStory::current();
+            for (auto j = 0; j < iterations; ++j) {
+                lock.lock(lockStory);
+                ++counter;
+                lock.unlock(lockStory);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter, threadsCount * iterations);
+}
+
+TYPED_TEST(TestQueueLock, TestNestedLocks) {
+    TypeParam outer;
+    TypeParam inner;
+    std::uint64_t counter = 0;
+    constexpr auto threadsCount = 4;
+    constexpr auto iterations = 5'000;
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&] {
+            for (auto j = 0; j < iterations; ++j) {
+                std::lock_guard outerLock{ outer };
+                std::lock_guard innerLock{ inner };
+                ++counter;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter, threadsCount * iterations);
+}
+
+TEST(TestMcsLock, TestTryLock) {
+    concurrency::McsLock lock;
+    concurrency::LockStory lockStory;
+
+    ASSERT_TRUE(lock.tryLock(lockStory).isOk());
+    std::thread other{[&lock] {
+        const auto result = lock.tryLock(concurrency::LockStory::current());
+        ASSERT_TRUE(result.isError());
+        EXPECT_EQ(result.error(), concurrency::LockError::WouldBlock);
+    }};
+    other.join();
+    lock.unlock(lockStory);
+
+    std::thread again{[&lock] {
+        EXPECT_TRUE(lock.try_lock());
+        lock.unlock();
+    }};
+    again.join();
+}
+
+#ifndef NDEBUG
+
+TYPED_TEST(TestQueueLock, TestLockStory) {
+    TypeParam lock;
+    concurrency::LockStory lockStory;
+
+    lock.lock(lockStory);
+    EXPECT_EQ(lockStory.size(), 1);
+    lock.unlock(lockStory);
+    EXPECT_TRUE(lockStory.empty());
+}
+
+TYPED_TEST(TestQueueLock, TestLockOrderWithSafeMutex) {
+    TypeParam lock;
+    concurrency::SafeMutex mutex;
+    concurrency::LockStory lockStory;
+
+    lock.lock(lockStory);
+    mutex.lock(lockStory);
+    mutex.unlock(lockStory);
+    lock.unlock(lockStory);
+
+    // The queue locks and SafeMutex share the lock order graph
+    mutex.lock(lockStory);
+    EXPECT_DEATH(lock.lock(lockStory), "PANIC");
+    mutex.unlock(lockStory);
+}
+
+TEST(TestMcsLock, TestTryLockHeldByStory) {
+    concurrency::McsLock lock;
+    concurrency::LockStory lockStory;
+
+    lock.lock(lockStory);
+    const auto result = lock.tryLock(lockStory);
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.error(), concurrency::LockError::Deadlock);
+    lock.unlock(lockStory);
+}
+
+#endif //! ifndef NDEBUG
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/ranked_mutex.h"
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace atom;
+
+namespace {
+
+template<typename Guard, typename Mutex>
+concept CanLockAfter = requires(Guard&& guard, Mutex& mutex) {
+    std::move(guard).lock(mutex);
+};
+
+// Locking through a guard which isn't consumed would let two siblings skip the order
+template<typename Guard, typename Mutex>
+concept CanLockSibling = requires(Guard& guard, Mutex& mutex) {
+    guard.lock(mutex);
+};
+
+using Guard1 = concurrency::RankedLock<1>;
+using Guard12 = concurrency::RankedLock<1, 2>;
+
+static_assert(CanLockAfter<Guard1, concurrency::RankedMutex<2>>);
+static_assert(CanLockAfter<Guard12, concurrency::RankedMutex<5>>);
+static_assert(!CanLockAfter<Guard1, concurrency::RankedMutex<1>>, "Equal rank must not compile");
+static_assert(!CanLockAfter<Guard12, concurrency::RankedMutex<1>>, "Lower rank must not compile");
+static_assert(!CanLockSibling<Guard1, concurrency::RankedMutex<2>>, "A guard must be consumed by lock()");
+static_assert(Guard12::MAX_RANK == 2);
+static_assert(sizeof(concurrency::RankedMutex<1>) == sizeof(std::mutex));
+
+// Logs the ids of the unlocked mutexes, the ids follow the order of construction starting from 1
+struct RecordingMutex {
+    static inline int created = 0;
+    static inline std::vector<int> unlocked;
+
+    const int id = ++created;
+
+    void lock() {}
+    void unlock() { unlocked.push_back(id); }
+};
+
+} //! namespace
+
+TEST(TestRankedMutex, TestLockInIncreasingRankOrder) {
+    concurrency::RankedMutex<1> m1;
+    concurrency::RankedMutex<2> m2;
+    concurrency::RankedMutex<3> m3;
+    int value = 0;
+
+    auto increment = [&] {
+        for (auto i = 0; i < 1000; ++i) {
+            auto lock1 = concurrency::LockRanked(m1);
+            auto lock2 = std::move(lock1).lock(m2);
+            auto lock3 = std::move(lock2).lock(m3);
+            ++value;
+        }
+    };
+
+    std::thread t1{ increment };
+    std::thread t2{ increment };
+    t1.join(); t2.join();
+
+    EXPECT_EQ(value, 2000);
+}
+
+TEST(TestRankedMutex, TestSkippingRanksAndEarlyUnlock) {
+    concurrency::RankedMutex<1> m1;
+    concurrency::RankedMutex<10> m10;
+
+    auto lock1 = concurrency::LockRanked(m1);
+    auto lock10 = std::move(lock1).lock(m10);
+    EXPECT_FALSE(lock1.ownsLock());
+    EXPECT_TRUE(lock10.ownsLock());
+
+    lock10.unlock();
+    EXPECT_FALSE(lock10.ownsLock());
+
+    // The chain is released as a whole
+    std::thread other{[&m1, &m10] {
+        auto lock = concurrency::LockRanked(m1);
+        auto next = std::move(lock).lock(m10);
+        EXPECT_TRUE(next.ownsLock());
+    }};
+    other.join();
+}
+
+TEST(TestRankedMutex, TestChainReleasesInReverseOrder) {
+    RecordingMutex::created = 0;
+    RecordingMutex::unlocked.clear();
+    concurrency::RankedMutex<1, RecordingMutex> m1;
+    concurrency::RankedMutex<2, RecordingMutex> m2;
+    concurrency::RankedMutex<3, RecordingMutex> m3;
+
+    {
+        auto lock = concurrency::LockRanked(m1).lock(m2).lock(m3);
+        EXPECT_TRUE(lock.ownsLock());
+        EXPECT_TRUE(RecordingMutex::unlocked.empty());
+    }
+
+    const std::vector<int> expected = { 3, 2, 1 };
+    EXPECT_EQ(RecordingMutex::unlocked, expected);
+}
+
+TEST(TestRankedMutex, TestLockThroughConsumedGuardPanics) {
+    concurrency::RankedMutex<1> m1;
+    concurrency::RankedMutex<2> m2;
+    concurrency::RankedMutex<3> m3;
+
+    EXPECT_DEATH({
+        auto lock1 = concurrency::LockRanked(m1);
+        auto lock2 = std::move(lock1).lock(m2);
+        auto sibling = std::move(lock1).lock(m3);
+    }, "PANIC");
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/rcu_sync.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace atom;
+
+namespace {
+
+std::atomic<int> liveTables{ 0 };
+
+// Every element of a consistent table has the same value
+struct Table final {
+    explicit Table(const std::size_t size, const int value): values(size, value) { ++liveTables; }
+    Table(const Table& other): values(other.values) { ++liveTables; }
+    ~Table() { --liveTables; }
+
+    bool isConsistent() const {
+        for (const auto value : values) {
+            if (value != values.front()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<int> values;
+};
+
+} //! namespace
+
+TEST(TestRcuSync, TestAccess) {
+    concurrency::RcuSync<std::vector<int>> values{ std::vector<int>{ 1, 2, 3 } };
+
+    values.accessImmutable([](const std::vector<int>& values) { EXPECT_EQ(values.size(), 3); });
+    values.accessMutable([](std::vector<int>& values) { values.push_back(4); });
+    EXPECT_EQ(values.read()->size(), 4);
+
+    values.setValue(std::vector<int>{ 5 });
+    EXPECT_EQ(values.getValue(), std::vector<int>{ 5 });
+}
+
+TEST(TestRcuSync, TestSnapshotOutlivesUpdate) {
+    concurrency::EpochDomain domain;
+    concurrency::RcuSync<std::vector<int>> values{ domain, std::vector<int>{ 1 } };
+
+    {
+        const auto snapshot = values.read();
+        values.setValue(std::vector<int>{ 2 });
+        EXPECT_EQ(domain.reclaim(), 0);
+        EXPECT_EQ(snapshot->front(), 1);
+        EXPECT_EQ(values.read()->front(), 2);
+    }
+
+    domain.synchronize();
+    EXPECT_EQ(domain.retiredCount(), 0);
+}
+
+TEST(TestRcuSync, TestThrowingUpdateKeepsVersion) {
+    concurrency::EpochDomain domain;
+    concurrency::RcuSync<Table> table{ domain, 4, 1 };
+    const auto live = liveTables.load();
+
+    EXPECT_THROW(table.accessMutable([](Table& table) {
+        table.values.front() = 2;
+        throw std::runtime_error{ "update failed" };
+    }), std::runtime_error);
+    EXPECT_EQ(liveTables.load(), live);
+    EXPECT_EQ(domain.retiredCount(), 0);
+    EXPECT_TRUE(table.read()->isConsistent());
+}
+
+TEST(TestRcuSync, TestReadersSeeConsistentVersions) {
+    {
+        concurrency::EpochDomain domain;
+        concurrency::RcuSync<Table> table{ domain, std::size_t{ 64 }, 0 };
+        std::atomic<bool> stop{ false };
+        constexpr auto readersCount = 3;
+        constexpr auto updates = 2'000;
+
+        std::vector<std::thread> readers;
+        for (auto i = 0; i < readersCount; ++i) {
+            readers.emplace_back([&] {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    const auto snapshot = table.read();
+                    ASSERT_TRUE(snapshot->isConsistent());
+                }
+            });
+        }
+
+        for (auto i = 1; i <= updates; ++i) {
+            table.accessMutable([i](Table& table) {
+                for (auto& value : table.values) {
+                    value = i;
+                }
+            });
+        }
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        EXPECT_EQ(table.read()->values.front(), updates);
+        domain.synchronize();
+        EXPECT_EQ(liveTables.load(), 1);
+    }
+    EXPECT_EQ(liveTables.load(), 0);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/recursive_safe_mutex.h"
+#include "include/concurrency/lock_order_graph.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace atom;
+using RecursiveSafeMutex = concurrency::RecursiveSafeMutex;
+
+TEST(TestRecursiveSafeMutex, TestReentry) {
+    RecursiveSafeMutex mutex;
+    concurrency::LockStory lockStory;
+
+    mutex.lock(lockStory);
+    mutex.lock(lockStory);
+    EXPECT_TRUE(mutex.tryLock(lockStory).isOk());
+    EXPECT_EQ(mutex.depth(lockStory), 3);
+
+    mutex.unlock(lockStory);
+    mutex.unlock(lockStory);
+    EXPECT_EQ(mutex.depth(lockStory), 1);
+    mutex.unlock(lockStory);
+    EXPECT_EQ(mutex.depth(lockStory), 0);
+}
+
+TEST(TestRecursiveSafeMutex, TestOtherThreadWaitsForLastUnlock) {
+    RecursiveSafeMutex mutex;
+
+    std::lock_guard outer{ mutex };
+    {
+        std::lock_guard inner{ mutex };
+        std::thread other{[&mutex] {
+            const auto result = mutex.tryLock(concurrency::LockStory::current());
+            EXPECT_TRUE(result.isError());
+            EXPECT_EQ(result.error(), concurrency::LockError::WouldBlock);
+        }};
+        other.join();
+    }
+
+    std::thread other{[&mutex] {
+        EXPECT_FALSE(mutex.try_lock());
+    }};
+    other.join();
+}
+
+TEST(TestRecursiveSafeMutex, TestRecursiveCounter) {
+    RecursiveSafeMutex mutex;
+    std::uint64_t counter = 0;
+    constexpr auto threadsCount = 4;
+    constexpr auto iterations = 10'000;
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&] {
+            for (auto j = 0; j < iterations; ++j) {
+                std::lock_guard outer{ mutex };
+                std::lock_guard inner{ mutex };
+                ++counter;
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter, threadsCount * iterations);
+}
+
+#ifndef NDEBUG
+
+TEST(TestRecursiveSafeMutex, TestOnlyFirstAcquisitionIsTracked) {
+    concurrency::SafeMutex outer;
+    RecursiveSafeMutex mutex;
+    concurrency::LockStory lockStory;
+
+    outer.lock(lockStory);
+    mutex.lock(lockStory);
+    mutex.lock(lockStory);
+    EXPECT_EQ(lockStory.size(), 2);
+    EXPECT_TRUE(concurrency::LockOrderGraph::instance().hasEdge(outer.id(), mutex.id()));
+
+    mutex.unlock(lockStory);
+    EXPECT_EQ(lockStory.size(), 2);
+    mutex.unlock(lockStory);
+    outer.unlock(lockStory);
+    EXPECT_TRUE(lockStory.empty());
+}
+
+#endif //! ifndef NDEBUG
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/lock_sampler.h"
+#include "include/concurrency/runtime_checks.h"
+#include "include/concurrency/safe_mutex.h"
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+
+using namespace atom;
+using RuntimeChecks = concurrency::RuntimeChecks;
+
+#if defined(NDEBUG) && defined(ATOM_RUNTIME_CHECKS)
+
+TEST(TestRuntimeChecks, TestLockOrderIsCheckedOnlyWhenEnabled) {
+    const auto enabled = RuntimeChecks::enabled();
+    concurrency::LockStory lockStory;
+    concurrency::SafeMutex m1;
+    concurrency::SafeMutex m2;
+
+    RuntimeChecks::setEnabled(false);
+    m2.lock(lockStory);
+    EXPECT_TRUE(m1.tryLockFor(lockStory, std::chrono::milliseconds(1)).isOk());
+    EXPECT_TRUE(lockStory.empty());
+    m1.unlock(lockStory);
+    m2.unlock(lockStory);
+
+    RuntimeChecks::setEnabled(true);
+    m1.lock(lockStory);
+    m2.lock(lockStory);
+    EXPECT_EQ(lockStory.size(), 2);
+    m2.unlock(lockStory);
+    m1.unlock(lockStory);
+
+    m2.lock(lockStory);
+    const auto result = m1.tryLockFor(lockStory, std::chrono::milliseconds(1));
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.error(), concurrency::LockError::Deadlock);
+    m2.unlock(lockStory);
+
+    RuntimeChecks::setEnabled(enabled);
+}
+
+TEST(TestRuntimeChecks, TestSamplerChecksLockOrderWhenDisabled) {
+    using LockSampler = concurrency::LockSampler;
+
+    const auto enabled = RuntimeChecks::enabled();
+    RuntimeChecks::setEnabled(false);
+    LockSampler::setInterval(1);
+    LockSampler::setReportHandler([](std::span<const std::uint32_t> , std::uint32_t ) {});
+    concurrency::LockStory lockStory;
+    concurrency::SafeMutex m1;
+    concurrency::SafeMutex m2;
+    const auto violations = LockSampler::violations();
+
+    m1.lock(lockStory);
+    ASSERT_TRUE(m2.tryLockFor(lockStory, std::chrono::milliseconds(1)).isOk());
+    m2.unlock(lockStory);
+    m1.unlock(lockStory);
+    EXPECT_EQ(LockSampler::violations(), violations);
+
+    // Reported by the sampler, the disabled checks neither abort nor fail the acquisition
+    m2.lock(lockStory);
+    m1.lock(lockStory);
+    m1.unlock(lockStory);
+    m2.unlock(lockStory);
+    EXPECT_EQ(LockSampler::violations(), violations + 1);
+    EXPECT_TRUE(lockStory.empty());
+
+    LockSampler::setInterval(0);
+    LockSampler::setReportHandler(nullptr);
+    RuntimeChecks::setEnabled(enabled);
+}
+
+#else
+
+TEST(TestRuntimeChecks, TestChecksFollowBuildType) {
+#ifdef NDEBUG
+    EXPECT_FALSE(RuntimeChecks::enabled());
+#else
+    EXPECT_TRUE(RuntimeChecks::enabled());
+#endif
+}
+
+#endif //! if defined(NDEBUG) && defined(ATOM_RUNTIME_CHECKS)
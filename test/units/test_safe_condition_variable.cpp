@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/safe_condition_variable.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace atom;
+using SafeMutex = concurrency::SafeMutex;
+using SafeConditionVariable = concurrency::SafeConditionVariable;
+
+TEST(TestSafeConditionVariable, TestProducerConsumer) {
+    SafeMutex mutex;
+    SafeConditionVariable condVar;
+    std::queue<int> values;
+    constexpr auto consumersCount = 4;
+    constexpr auto valuesCount = 10'000;
+
+    std::vector<std::thread> consumers;
+    std::vector<std::uint64_t> sums(consumersCount, 0);
+    for (auto i = 0; i < consumersCount; ++i) {
+        consumers.emplace_back([&, i] {
+            auto& lockStory = concurrency::LockStory::current();
+            while (true) {
+                mutex.lock(lockStory);
+                condVar.wait(mutex, lockStory, [&values] { return !values.empty(); });
+                const auto value = values.front();
+                values.pop();
+                mutex.unlock(lockStory);
+
+                if (value < 0) {
+                    return;
+                }
+                sums[i] += value;
+            }
+        });
+    }
+
+    for (auto i = 1; i <= valuesCount + consumersCount; ++i) {
+        std::lock_guard lock{ mutex };
+        values.push(i <= valuesCount ? i : -1);
+        condVar.notifyOne();
+    }
+
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    std::uint64_t total = 0;
+    for (const auto sum : sums) {
+        total += sum;
+    }
+    EXPECT_EQ(total, std::uint64_t{ valuesCount } * (valuesCount + 1) / 2);
+}
+
+TEST(TestSafeConditionVariable, TestNotifyAllHandsMutexToEveryWaiter) {
+    for (const auto policy : { concurrency::WaitPolicy::Fifo, concurrency::WaitPolicy::Barging }) {
+        SafeMutex mutex{ policy };
+        SafeConditionVariable condVar;
+        auto ready = false;
+        auto waiting = 0;
+        auto woken = 0;
+        constexpr auto threadsCount = 8;
+
+        std::vector<std::thread> threads;
+        for (auto i = 0; i < threadsCount; ++i) {
+            threads.emplace_back([&] {
+                std::unique_lock lock{ mutex };
+                ++waiting;
+                condVar.wait(mutex, concurrency::LockStory::current(), [&ready] { return ready; });
+                ++woken;
+            });
+        }
+
+        while (true) {
+            std::lock_guard lock{ mutex };
+            if (waiting == threadsCount) {
+                // Every waiter is moved to the wait list of the mutex we hold
+                ready = true;
+                condVar.notifyAll();
+                break;
+            }
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(woken, threadsCount);
+    }
+}
+
+TEST(TestSafeConditionVariable, TestTimeout) {
+    SafeMutex mutex;
+    SafeConditionVariable condVar;
+    auto& lockStory = concurrency::LockStory::current();
+
+    mutex.lock(lockStory);
+    EXPECT_EQ(condVar.waitFor(mutex, lockStory, std::chrono::milliseconds(10)), std::cv_status::timeout);
+    EXPECT_FALSE(condVar.waitFor(mutex, lockStory, std::chrono::milliseconds(10), [] { return false; }));
+    EXPECT_TRUE(condVar.waitUntil(mutex, lockStory, std::chrono::system_clock::now(), [] { return true; }));
+    // The mutex is held again after the timeout
+    EXPECT_FALSE(mutex.tryLock(lockStory).isOk());
+    mutex.unlock(lockStory);
+}
+
+#ifndef NDEBUG
+
+TEST(TestSafeConditionVariable, TestMutexReentersStoryAfterWait) {
+    SafeMutex outer;
+    SafeMutex mutex;
+    SafeConditionVariable condVar;
+    auto notified = false;
+    auto waiting = false;
+
+    std::thread waiter{[&] {
+        auto& lockStory = concurrency::LockStory::current();
+        outer.lock(lockStory);
+        mutex.lock(lockStory);
+        waiting = true;
+        condVar.wait(mutex, lockStory, [&notified] { return notified; });
+        EXPECT_EQ(lockStory.size(), 2);
+        const auto result = mutex.tryLock(lockStory);
+        ASSERT_TRUE(result.isError());
+        EXPECT_EQ(result.error(), concurrency::LockError::Deadlock);
+        mutex.unlock(lockStory);
+        outer.unlock(lockStory);
+    }};
+
+    while (true) {
+        std::lock_guard lock{ mutex };
+        if (waiting) {
+            notified = true;
+            condVar.notifyOne();
+            break;
+        }
+    }
+    waiter.join();
+}
+
+TEST(TestSafeConditionVariable, TestMorphedReacquireChecksLockOrder) {
+    const auto inversedReacquire = [] {
+        SafeMutex mutex;
+        SafeMutex other;
+        SafeConditionVariable condVar;
+        std::atomic<bool> waiting = false;
+        auto notified = false;
+
+        std::thread waiter{[&] {
+            auto& lockStory = concurrency::LockStory::current();
+            mutex.lock(lockStory);
+            other.lock(lockStory);
+            waiting = true;
+            // The mutex comes back while `other` is held: other -> mutex inverts mutex -> other
+            condVar.wait(mutex, lockStory, [&notified] { return notified; });
+        }};
+
+        while (!waiting.load()) {
+            std::this_thread::yield();
+        }
+        {
+            // The notifier holds the mutex, so the waiter is morphed onto it instead of being woken up
+            std::lock_guard lock{ mutex };
+            notified = true;
+            condVar.notifyOne();
+        }
+        waiter.join();
+    };
+
+    EXPECT_DEATH(inversedReacquire(), "PANIC");
+}
+
+#endif //! ifndef NDEBUG
@@ -1,7 +1,15 @@
 #include <gtest/gtest.h>
 
 #include "include/concurrency/safe_mutex.h"
+#include "include/concurrency/lock_order_graph.h"
 #include <iostream>
+#include <condition_variable>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
 
 using namespace atom;
 using LockGraphType = concurrency::LockStory::GraphType;
@@ -79,3 +87,563 @@ TEST(TestSafeMutex, TestSelfDeadlockWithOneMutex) {
     EXPECT_EQ(graph.size(), 1);
     EXPECT_TRUE(concurrency::CheckIntersections(graph));
 }
+
+TEST(TestSafeMutex, TestDetectingRingDeadlock) {
+    SafeMutex m1, m2, m3;
+    LockGraphType graph;
+
+    LockStoryListType l1 = {&m1, &m2};
+    LockStoryListType l2 = {&m2, &m3};
+    concurrency::MakeGraph(l1, l2, graph);
+    EXPECT_FALSE(concurrency::CheckIntersections(graph));
+
+    graph.insert(std::make_pair(&m3, &m1));
+    EXPECT_TRUE(concurrency::CheckIntersections(graph));
+}
+
+TEST(TestSafeMutex, TestLockOrderGraphRecordsEdgeOnce) {
+    SafeMutex m1, m2;
+    auto& graph = concurrency::LockOrderGraph::instance();
+
+    EXPECT_FALSE(graph.hasEdge(m1.id(), m2.id()));
+    EXPECT_TRUE(graph.addEdge(m1.id(), m2.id()));
+    EXPECT_TRUE(graph.hasEdge(m1.id(), m2.id()));
+    EXPECT_TRUE(graph.addEdge(m1.id(), m2.id()));
+    EXPECT_FALSE(graph.hasEdge(m2.id(), m1.id()));
+}
+
+TEST(TestSafeMutex, TestLockOrderGraphDetectsCycle) {
+    SafeMutex m1, m2, m3;
+    auto& graph = concurrency::LockOrderGraph::instance();
+
+    EXPECT_TRUE(graph.addEdge(m1.id(), m2.id()));
+    EXPECT_TRUE(graph.addEdge(m2.id(), m3.id()));
+    EXPECT_FALSE(graph.addEdge(m3.id(), m1.id()));
+    EXPECT_FALSE(graph.addEdge(m1.id(), m1.id()));
+    EXPECT_FALSE(graph.hasEdge(m3.id(), m1.id()));
+}
+
+TEST(TestSafeMutex, TestLockOrderGraphForgetsPathsThroughRemovedNode) {
+    SafeMutex m1, m3;
+    auto& graph = concurrency::LockOrderGraph::instance();
+    {
+        SafeMutex m2;
+        EXPECT_TRUE(graph.addEdge(m1.id(), m2.id()));
+        EXPECT_TRUE(graph.addEdge(m2.id(), m3.id()));
+        EXPECT_FALSE(graph.addEdge(m3.id(), m1.id()));
+    }
+
+    EXPECT_TRUE(graph.addEdge(m3.id(), m1.id()));
+}
+
+TEST(TestSafeMutex, TestUnorderedLocksStayOutOfLockOrderGraph) {
+    auto& graph = concurrency::LockOrderGraph::instance();
+    const auto nodes = graph.size();
+    {
+        std::vector<std::unique_ptr<SafeMutex>> mutexes;
+        for (auto i = 0; i < 1000; ++i) {
+            mutexes.push_back(std::make_unique<SafeMutex>());
+        }
+        EXPECT_EQ(graph.size(), nodes);
+
+        EXPECT_TRUE(graph.addEdge(mutexes[0]->id(), mutexes[1]->id()));
+        EXPECT_EQ(graph.size(), nodes + 2);
+    }
+    EXPECT_EQ(graph.size(), nodes);
+}
+
+TEST(TestSafeMutex, TestLockIdIsReused) {
+    std::uint32_t id = 0;
+    {
+        SafeMutex mutex;
+        id = mutex.id();
+    }
+
+    SafeMutex mutex;
+    EXPECT_EQ(mutex.id(), id);
+}
+
+TEST(TestSafeMutex, TestStdScopedLock) {
+    SafeMutex m1, m2;
+    int value = 0;
+
+    auto increment = [&] {
+        for (auto i = 0; i < 1000; ++i) {
+            std::scoped_lock lock{ m1, m2 };
+            ++value;
+        }
+    };
+
+    std::thread t1{ increment };
+    std::thread t2{ increment };
+    t1.join(); t2.join();
+
+    EXPECT_EQ(value, 2000);
+}
+
+TEST(TestSafeMutex, TestStdConditionVariableAny) {
+    SafeMutex mutex;
+    std::condition_variable_any condVar;
+    bool ready = false;
+
+    std::thread producer{[&] {
+        std::unique_lock lock{ mutex };
+        ready = true;
+        condVar.notify_one();
+    }};
+
+    {
+        std::unique_lock lock{ mutex };
+        condVar.wait(lock, [&ready] { return ready; });
+        EXPECT_TRUE(ready);
+    }
+
+    producer.join();
+}
+
+TEST(TestSafeMutex, TestTryLock) {
+    SafeMutex mutex;
+
+    EXPECT_TRUE(mutex.try_lock());
+    std::thread other{[&mutex] {
+        EXPECT_FALSE(mutex.try_lock());
+    }};
+    other.join();
+    mutex.unlock();
+
+    std::thread another{[&mutex] {
+        EXPECT_TRUE(mutex.try_lock());
+        mutex.unlock();
+    }};
+    another.join();
+}
+
+TEST(TestSafeMutex, TestTryLockForTimesOut) {
+    using namespace std::chrono_literals;
+    SafeMutex mutex;
+    concurrency::LockStory lockStory;
+
+    mutex.lock(lockStory);
+    std::thread other{[&mutex] {
+        concurrency::LockStory otherLockStory;
+        const auto result = mutex.tryLockFor(otherLockStory, 10ms);
+        EXPECT_TRUE(result.isError());
+        EXPECT_EQ(result.error(), concurrency::LockError::Timeout);
+
+        const auto tryResult = mutex.tryLock(otherLockStory);
+        EXPECT_TRUE(tryResult.isError());
+        EXPECT_EQ(tryResult.error(), concurrency::LockError::WouldBlock);
+    }};
+    other.join();
+    mutex.unlock(lockStory);
+
+    const auto result = mutex.tryLockUntil(lockStory, std::chrono::system_clock::now() + 10ms);
+    EXPECT_TRUE(result.isOk());
+    mutex.unlock(lockStory);
+}
+
+TEST(TestSafeMutex, TestTryLockForAcquiresReleasedMutex) {
+    using namespace std::chrono_literals;
+    SafeMutex mutex;
+    concurrency::LockStory lockStory;
+    std::atomic<bool> waiting = false;
+
+    mutex.lock(lockStory);
+    std::thread other{[&] {
+        concurrency::LockStory otherLockStory;
+        waiting = true;
+        const auto result = mutex.tryLockFor(otherLockStory, 10s);
+        EXPECT_TRUE(result.isOk());
+        mutex.unlock(otherLockStory);
+    }};
+
+    while (!waiting.load()) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(1ms);
+    mutex.unlock(lockStory);
+    other.join();
+}
+
+TEST(TestSafeMutex, TestContendedCounter) {
+    for (const auto policy : { concurrency::WaitPolicy::Fifo, concurrency::WaitPolicy::Barging }) {
+        SafeMutex mutex{ policy };
+        std::uint64_t counter = 0;
+        constexpr auto threadsCount = 8;
+        constexpr auto iterations = 20'000;
+
+        std::vector<std::thread> threads;
+        for (auto i = 0; i < threadsCount; ++i) {
+            threads.emplace_back([&] {
+                for (auto j = 0; j < iterations; ++j) {
+                    std::lock_guard lock{ mutex };
+                    ++counter;
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        EXPECT_EQ(counter, threadsCount * iterations);
+    }
+}
+
+TEST(TestSafeMutex, TestTimedAndUntimedWaitersKeepExclusion) {
+    for (const auto policy : { concurrency::WaitPolicy::Fifo, concurrency::WaitPolicy::Barging }) {
+        SafeMutex mutex{ policy };
+        std::atomic<int> owners = 0;
+        std::uint64_t counter = 0;
+        std::atomic<std::uint64_t> acquired = 0;
+        constexpr auto threadsCount = 8;
+        constexpr auto iterations = 2'000;
+
+        // The timed waiters time out in the middle of the queue and next to the hand-offs to the untimed ones
+        std::vector<std::thread> threads;
+        for (auto i = 0; i < threadsCount; ++i) {
+            threads.emplace_back([&, timed = i % 2 == 0] {
+                concurrency::LockStory lockStory;
+                for (auto j = 0; j < iterations; ++j) {
+                    if (timed) {
+                        if (mutex.tryLockFor(lockStory, std::chrono::microseconds{ 50 + j % 50 }).isError()) {
+                            continue;
+                        }
+                    } else {
+                        mutex.lock(lockStory);
+                    }
+
+                    EXPECT_EQ(owners.fetch_add(1), 0);
+                    ++counter;
+                    if (j % 8 == 0) {
+                        // Let the others park behind the owner
+                        std::this_thread::sleep_for(std::chrono::microseconds{ 50 });
+                    }
+                    owners.fetch_sub(1);
+                    acquired.fetch_add(1, std::memory_order_relaxed);
+                    mutex.unlock(lockStory);
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        EXPECT_EQ(counter, acquired.load());
+        EXPECT_TRUE(mutex.tryLock(concurrency::LockStory::current()).isOk());
+        mutex.unlock(concurrency::LockStory::current());
+    }
+}
+
+#ifdef ATOM_CHECKED_BUILD
+
+namespace {
+
+// Starts the waiter and gives it the time to spin out and park in the wait list of the mutex
+template<typename Func>
+std::thread StartParkedWaiter(Func waiter) {
+    std::atomic<bool> started = false;
+    std::thread thread{[&started, waiter] {
+        started = true;
+        waiter();
+    }};
+
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+    return thread;
+}
+
+} //! namespace
+
+TEST(TestSafeMutex, TestFifoHandOffOrder) {
+    SafeMutex mutex{ concurrency::WaitPolicy::Fifo };
+    concurrency::LockStory lockStory;
+    std::vector<int> order;
+
+    mutex.lock(lockStory);
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 4; ++i) {
+        threads.push_back(StartParkedWaiter([&mutex, &order, i] {
+            concurrency::LockStory waiterLockStory;
+            mutex.lock(waiterLockStory);
+            order.push_back(i);
+            mutex.unlock(waiterLockStory);
+        }));
+    }
+    mutex.unlock(lockStory);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1, 2, 3 }));
+}
+
+TEST(TestSafeMutex, TestTimedOutWaiterLeavesMiddleOfQueue) {
+    SafeMutex mutex{ concurrency::WaitPolicy::Fifo };
+    concurrency::LockStory lockStory;
+    std::vector<int> order;
+    std::atomic<bool> timedOut = false;
+
+    const auto waiter = [&mutex, &order](const int index) {
+        return [&mutex, &order, index] {
+            concurrency::LockStory waiterLockStory;
+            mutex.lock(waiterLockStory);
+            order.push_back(index);
+            mutex.unlock(waiterLockStory);
+        };
+    };
+
+    mutex.lock(lockStory);
+    auto first = StartParkedWaiter(waiter(0));
+    auto timed = StartParkedWaiter([&mutex, &timedOut] {
+        concurrency::LockStory waiterLockStory;
+        const auto result = mutex.tryLockFor(waiterLockStory, std::chrono::milliseconds{ 50 });
+        EXPECT_TRUE(result.isError());
+        timedOut = result.isError() && result.error() == concurrency::LockError::Timeout;
+    });
+    auto last = StartParkedWaiter(waiter(2));
+
+    timed.join();
+    EXPECT_TRUE(timedOut.load());
+    mutex.unlock(lockStory);
+
+    first.join();
+    last.join();
+    EXPECT_EQ(order, (std::vector<int>{ 0, 2 }));
+}
+
+TEST(TestSafeMutex, TestEachUnlockHandsOffToOneWaiter) {
+    SafeMutex mutex{ concurrency::WaitPolicy::Fifo };
+    concurrency::LockStory lockStory;
+    constexpr auto waitersCount = 3;
+    std::atomic<int> acquired = 0;
+    std::array<std::atomic<bool>, waitersCount> released{};
+
+    mutex.lock(lockStory);
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < waitersCount; ++i) {
+        threads.push_back(StartParkedWaiter([&mutex, &acquired, &released, i] {
+            concurrency::LockStory waiterLockStory;
+            mutex.lock(waiterLockStory);
+            ++acquired;
+            while (!released[i].load()) {
+                std::this_thread::yield();
+            }
+            mutex.unlock(waiterLockStory);
+        }));
+    }
+
+    // Every unlock hands the mutex to the head of the queue alone, the rest keep sleeping
+    mutex.unlock(lockStory);
+    for (auto i = 0; i < waitersCount; ++i) {
+        while (acquired.load() != i + 1) {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+        EXPECT_EQ(acquired.load(), i + 1);
+        released[i] = true;
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+#endif //! ifdef ATOM_CHECKED_BUILD
+
+TEST(TestSafeMutex, TestLockAllInOppositeArgumentOrder) {
+    SafeMutex m1, m2, m3;
+    int value = 0;
+
+    std::thread t1{[&] {
+        for (auto i = 0; i < 1000; ++i) {
+            concurrency::MultiLockGuard guard{ m1, m2, m3 };
+            ++value;
+        }
+    }};
+
+    std::thread t2{[&] {
+        concurrency::LockStory lockStory;
+        for (auto i = 0; i < 1000; ++i) {
+            concurrency::MultiLockGuard guard{ lockStory, m3, m2, m1 };
+            ++value;
+        }
+    }};
+
+    t1.join(); t2.join();
+    EXPECT_EQ(value, 2000);
+}
+
+TEST(TestSafeMutex, TestLockAllBacksOff) {
+    SafeMutex m1, m2;
+    concurrency::LockStory lockStory;
+
+    m2.lock(lockStory);
+    std::atomic<bool> locked = false;
+    std::thread other{[&] {
+        concurrency::LockStory otherLockStory;
+        concurrency::LockAll(otherLockStory, m1, m2);
+        locked = true;
+        concurrency::UnlockAll(otherLockStory, std::array{ &m1, &m2 });
+    }};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    EXPECT_FALSE(locked.load());
+    // The group has backed off, so m1 is not held while m2 is busy
+    EXPECT_TRUE(m1.tryLock(lockStory).isOk());
+    m1.unlock(lockStory);
+    m2.unlock(lockStory);
+
+    other.join();
+    EXPECT_TRUE(locked.load());
+}
+
+#ifndef NDEBUG
+
+TEST(TestSafeMutex, TestLockAllRecordsOnlyExternalEdges) {
+    SafeMutex outer, m1, m2;
+    concurrency::LockStory lockStory;
+    auto& graph = concurrency::LockOrderGraph::instance();
+
+    outer.lock(lockStory);
+    concurrency::LockAll(lockStory, m2, m1);
+    EXPECT_EQ(lockStory.size(), 3);
+    EXPECT_TRUE(graph.hasEdge(outer.id(), m1.id()));
+    EXPECT_TRUE(graph.hasEdge(outer.id(), m2.id()));
+    EXPECT_FALSE(graph.hasEdge(m1.id(), m2.id()));
+    EXPECT_FALSE(graph.hasEdge(m2.id(), m1.id()));
+
+    concurrency::UnlockAll(lockStory, std::array{ &m1, &m2 });
+    outer.unlock(lockStory);
+    EXPECT_TRUE(lockStory.empty());
+}
+
+TEST(TestSafeMutex, TestTryLockReportsDeadlock) {
+    using namespace std::chrono_literals;
+    SafeMutex m1, m2;
+    concurrency::LockStory lockStory;
+
+    m1.lock(lockStory);
+    m2.lock(lockStory);
+    m2.unlock(lockStory);
+    m1.unlock(lockStory);
+
+    m2.lock(lockStory);
+    const auto result = m1.tryLockFor(lockStory, 10ms);
+    EXPECT_TRUE(result.isError());
+    EXPECT_EQ(result.error(), concurrency::LockError::Deadlock);
+    EXPECT_EQ(lockStory.size(), 1);
+
+    const auto selfResult = m2.tryLock(lockStory);
+    EXPECT_TRUE(selfResult.isError());
+    EXPECT_EQ(selfResult.error(), concurrency::LockError::Deadlock);
+    m2.unlock(lockStory);
+}
+
+TEST(TestSafeMutex, TestTryLockReportsRingDeadlock) {
+    using namespace std::chrono_literals;
+    SafeMutex m1, m2, m3;
+    concurrency::LockStory lockStory;
+
+    // Three code paths which never collide pairwise but deadlock together: 1 -> 2, 2 -> 3, 3 -> 1
+    for (auto [first, second] : { std::pair{ &m1, &m2 }, std::pair{ &m2, &m3 } }) {
+        first->lock(lockStory);
+        second->lock(lockStory);
+        second->unlock(lockStory);
+        first->unlock(lockStory);
+    }
+
+    m3.lock(lockStory);
+    const auto result = m1.tryLockFor(lockStory, 10ms);
+    EXPECT_TRUE(result.isError());
+    EXPECT_EQ(result.error(), concurrency::LockError::Deadlock);
+    m3.unlock(lockStory);
+}
+
+TEST(TestSafeMutex, TestLockStoryReleaseOrder) {
+    SafeMutex m1, m2, m3;
+    concurrency::LockStory lockStory;
+
+    m1.lock(lockStory);
+    m2.lock(lockStory);
+    m3.lock(lockStory);
+    EXPECT_EQ(lockStory.size(), 3);
+
+    // Not LIFO
+    m2.unlock(lockStory);
+    EXPECT_EQ(lockStory.size(), 2);
+
+    m3.unlock(lockStory);
+    m1.unlock(lockStory);
+    EXPECT_TRUE(lockStory.empty());
+}
+
+TEST(TestSafeMutex, TestImplicitLockStoryIsThreadLocal) {
+    SafeMutex mutex;
+
+    mutex.lock();
+    EXPECT_EQ(concurrency::LockStory::current().size(), 1);
+
+    std::thread other{[] {
+        EXPECT_TRUE(concurrency::LockStory::current().empty());
+    }};
+    other.join();
+
+    mutex.unlock();
+    EXPECT_TRUE(concurrency::LockStory::current().empty());
+}
+
+TEST(TestSafeMutex, TestLockOrderGraphForgetsDestroyedMutex) {
+    auto& graph = concurrency::LockOrderGraph::instance();
+    SafeMutex m1;
+    std::uint32_t m2Id = 0;
+    {
+        SafeMutex m2;
+        m2Id = m2.id();
+        EXPECT_TRUE(graph.addEdge(m1.id(), m2.id()));
+    }
+
+    EXPECT_FALSE(graph.hasEdge(m1.id(), m2Id));
+
+    // The id is reused by the next mutex, which must not inherit the edge
+    SafeMutex m3;
+    EXPECT_EQ(m3.id(), m2Id);
+    EXPECT_FALSE(graph.hasEdge(m1.id(), m3.id()));
+}
+
+TEST(TestSafeMutex, TestNestedLockInKnownOrder) {
+    SafeMutex m1, m2;
+    concurrency::LockStory lockStory;
+
+    for (auto i = 0; i < 3; ++i) {
+        m1.lock(lockStory);
+        m2.lock(lockStory);
+        m2.unlock(lockStory);
+        m1.unlock(lockStory);
+    }
+
+    EXPECT_TRUE(concurrency::LockOrderGraph::instance().hasEdge(m1.id(), m2.id()));
+}
+
+TEST(TestSafeMutex, TestInversedLockOrderPanics) {
+    auto inversedLockOrder = [] {
+        SafeMutex m1;
+        SafeMutex m2;
+        concurrency::LockStory lockStory;
+
+        m1.lock(lockStory);
+        m2.lock(lockStory);
+        m2.unlock(lockStory);
+        m1.unlock(lockStory);
+
+        m2.lock(lockStory);
+        m1.lock(lockStory);
+    };
+
+    EXPECT_DEATH(inversedLockOrder(), "PANIC");
+}
+
+#endif //! ifndef NDEBUG
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/safe_shared_mutex.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace atom;
+using SafeMutex = concurrency::SafeMutex;
+using SafeSharedMutex = concurrency::SafeSharedMutex;
+
+TEST(TestSafeSharedMutex, TestReadersProceedInParallel) {
+    SafeSharedMutex mutex;
+    std::atomic<int> readersInside = 0;
+    std::atomic<bool> metEachOther = false;
+
+    auto reader = [&] {
+        concurrency::LockStory lockStory;
+        mutex.lockShared(lockStory);
+        ++readersInside;
+        // Both readers must be able to be inside the critical section at the same time
+        while (readersInside.load() < 2) {
+            std::this_thread::yield();
+        }
+        metEachOther = true;
+        mutex.unlockShared(lockStory);
+    };
+
+    std::thread t1{ reader };
+    std::thread t2{ reader };
+    t1.join(); t2.join();
+
+    EXPECT_TRUE(metEachOther.load());
+}
+
+TEST(TestSafeSharedMutex, TestWriterExcludesReadersAndWriters) {
+    constexpr auto ITERATIONS = 1000;
+    SafeSharedMutex mutex;
+    std::uint64_t first = 0;
+    std::uint64_t second = 0;
+    std::atomic<bool> tornRead = false;
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 2; ++i) {
+        threads.emplace_back([&] {
+            concurrency::LockStory lockStory;
+            for (auto j = 0; j < ITERATIONS; ++j) {
+                mutex.lock(lockStory);
+                ++first;
+                ++second;
+                mutex.unlock(lockStory);
+            }
+        });
+    }
+
+    for (auto i = 0; i < 2; ++i) {
+        threads.emplace_back([&] {
+            concurrency::LockStory lockStory;
+            for (auto j = 0; j < ITERATIONS; ++j) {
+                mutex.lockShared(lockStory);
+                if (first != second) {
+                    tornRead = true;
+                }
+                mutex.unlockShared(lockStory);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_FALSE(tornRead.load());
+    EXPECT_EQ(first, 2 * ITERATIONS);
+    EXPECT_EQ(second, 2 * ITERATIONS);
+}
+
+#ifndef NDEBUG
+
+TEST(TestSafeSharedMutex, TestReadToWriteUpgradePanics) {
+    auto upgrade = [] {
+        SafeSharedMutex mutex;
+        concurrency::LockStory lockStory;
+
+        mutex.lockShared(lockStory);
+        mutex.lock(lockStory);
+    };
+
+    EXPECT_DEATH(upgrade(), "PANIC");
+}
+
+TEST(TestSafeSharedMutex, TestOrderingCycleWithSafeMutexPanics) {
+    auto inversedLockOrder = [] {
+        SafeSharedMutex sharedMutex;
+        SafeMutex mutex;
+        concurrency::LockStory lockStory;
+
+        sharedMutex.lockShared(lockStory);
+        mutex.lock(lockStory);
+        mutex.unlock(lockStory);
+        sharedMutex.unlockShared(lockStory);
+
+        mutex.lock(lockStory);
+        sharedMutex.lockShared(lockStory);
+    };
+
+    EXPECT_DEATH(inversedLockOrder(), "PANIC");
+}
+
+#endif //! ifndef NDEBUG
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/seqlock_sync.h"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace atom;
+
+namespace {
+
+struct Quote final {
+    std::int64_t bid;
+    std::int64_t ask;
+    std::int32_t size;
+};
+
+} //! namespace
+
+TEST(TestSeqlockSync, TestAccess) {
+    concurrency::SeqlockSync<Quote> quote{ Quote{ 100, 101, 5 } };
+    EXPECT_EQ(quote.version(), 0);
+
+    quote.accessImmutable([](const Quote& quote) {
+        EXPECT_EQ(quote.bid, 100);
+        EXPECT_EQ(quote.ask, 101);
+        EXPECT_EQ(quote.size, 5);
+    });
+
+    quote.accessMutable([](Quote& quote) { quote.bid = 99; });
+    EXPECT_EQ(quote.getValue().bid, 99);
+    EXPECT_EQ(quote.getValue().ask, 101);
+
+    quote.setValue(Quote{ 1, 2, 3 });
+    EXPECT_EQ(quote.getValue().size, 3);
+    EXPECT_EQ(quote.version(), 2);
+}
+
+TEST(TestSeqlockSync, TestThrowingUpdateKeepsValue) {
+    concurrency::SeqlockSync<Quote> quote{ Quote{ 100, 101, 5 } };
+
+    EXPECT_THROW(quote.accessMutable([](Quote& quote) {
+        quote.bid = 99;
+        throw std::runtime_error{ "update failed" };
+    }), std::runtime_error);
+
+    // The write is over, so neither readers nor writers wait for it
+    EXPECT_EQ(quote.version(), 1);
+    EXPECT_EQ(quote.getValue().bid, 100);
+    quote.setValue(Quote{ 1, 2, 3 });
+    EXPECT_EQ(quote.getValue().bid, 1);
+    EXPECT_EQ(quote.version(), 2);
+}
+
+TEST(TestSeqlockSync, TestReadersNeverSeeTornValue) {
+    // The ask is always bid + 1, a torn copy would break it
+    concurrency::SeqlockSync<Quote> quote{ Quote{ 0, 1, 0 } };
+    std::atomic<bool> stop{ false };
+    constexpr auto readersCount = 3;
+    constexpr auto writes = 20'000;
+
+    std::vector<std::thread> readers;
+    for (auto i = 0; i < readersCount; ++i) {
+        readers.emplace_back([&] {
+            std::int64_t lastBid = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const auto value = quote.getValue();
+                ASSERT_EQ(value.ask, value.bid + 1);
+                ASSERT_EQ(value.size, static_cast<std::int32_t>(value.bid));
+                ASSERT_GE(value.bid, lastBid);
+                lastBid = value.bid;
+            }
+        });
+    }
+
+    for (auto i = 1; i <= writes; ++i) {
+        quote.accessMutable([i](Quote& quote) {
+            quote.bid = i;
+            quote.ask = i + 1;
+            quote.size = i;
+        });
+    }
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(quote.getValue().bid, writes);
+}
+
+TEST(TestSeqlockSync, TestWritersAreSerialized) {
+    concurrency::SeqlockSync<std::uint64_t> counter{ std::uint64_t{ 0 } };
+    constexpr auto writersCount = 4;
+    constexpr auto iterations = 10'000;
+
+    std::vector<std::thread> writers;
+    for (auto i = 0; i < writersCount; ++i) {
+        writers.emplace_back([&] {
+            for (auto j = 0; j < iterations; ++j) {
+                counter.accessMutable([](std::uint64_t& value) { ++value; });
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_EQ(counter.getValue(), writersCount * iterations);
+    EXPECT_EQ(counter.version(), writersCount * iterations);
+}
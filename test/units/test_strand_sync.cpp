@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/strand_sync.h"
+
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace atom;
+
+TEST(TestStrandSync, TestDroppedFuturesStillApplyInOrder) {
+    concurrency::StrandSync<std::vector<int>> values{ std::vector<int>{ 1, 2 } };
+
+    // Nothing waits for these, the overwrite in the middle tells that they ran exactly in the order of posting
+    values.accessMutable([](std::vector<int>& values) { values.push_back(3); });
+    values.setValue(std::vector<int>{ 4 });
+    values.post([](std::vector<int>& values) { values.push_back(5); });
+
+    const std::vector<int> expected = { 4, 5 };
+    EXPECT_EQ(values.getValue(), expected);
+}
+
+TEST(TestStrandSync, TestValueIsOwnedByExecutor) {
+    concurrency::StrandSync<int> value{ 0 };
+
+    EXPECT_FALSE(value.isExecutorThread());
+    const auto executorThread = value.accessMutable([&value](int& ) {
+        EXPECT_TRUE(value.isExecutorThread());
+        return std::this_thread::get_id();
+    }).get();
+    EXPECT_NE(executorThread, std::this_thread::get_id());
+    EXPECT_EQ(value.accessImmutable([](const int& ) { return std::this_thread::get_id(); }).get(), executorThread);
+}
+
+TEST(TestStrandSync, TestTasksOfProducerRunInOrder) {
+    concurrency::StrandSync<std::vector<std::vector<int>>> values{ std::size_t{ 8 } };
+    constexpr auto threadsCount = 8;
+    constexpr auto iterations = 5'000;
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&values, i] {
+            for (auto j = 0; j < iterations; ++j) {
+                values.post([i, j](std::vector<std::vector<int>>& values) { values[i].push_back(j); });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto all = values.getValue();
+    for (const auto& thread : all) {
+        ASSERT_EQ(thread.size(), iterations);
+        for (auto j = 0; j < iterations; ++j) {
+            ASSERT_EQ(thread[j], j);
+        }
+    }
+}
+
+TEST(TestStrandSync, TestExceptionGoesToFuture) {
+    concurrency::StrandSync<int> value{ 0 };
+
+    auto failed = value.accessMutable([](int& ) { throw std::runtime_error("failed"); });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+    value.accessMutable([](int& value) { ++value; });
+    EXPECT_EQ(value.getValue(), 1);
+}
+
+TEST(TestStrandSync, TestDestructorRunsPostedTasks) {
+    std::atomic<int> done = 0;
+    {
+        concurrency::StrandSync<int> value{ 0 };
+        for (auto i = 0; i < 1'000; ++i) {
+            value.post([&done](int& value) { ++value; ++done; });
+        }
+    }
+    EXPECT_EQ(done.load(), 1'000);
+}
+
+TEST(TestStrandSync, TestGetValueOnExecutorPanics) {
+    EXPECT_DEATH({
+        concurrency::StrandSync<int> value{ 0 };
+        value.accessMutable([&value](int& ) { value.getValue(); }).get();
+    }, "PANIC");
+}
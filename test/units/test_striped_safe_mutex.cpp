@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include "include/concurrency/striped_safe_mutex.h"
+#include "include/concurrency/lock_order_graph.h"
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace atom;
+
+TEST(TestStripedSafeMutex, TestStripesArePadded) {
+    using Striped = concurrency::StripedSafeMutex<8>;
+    Striped stripes;
+
+    EXPECT_GE(sizeof(Striped), Striped::STRIPES * utils::CACHE_LINE_SIZE);
+    for (std::size_t i = 1; i < Striped::STRIPES; ++i) {
+        const auto distance = reinterpret_cast<std::uintptr_t>(&stripes.stripe(i)) -
+            reinterpret_cast<std::uintptr_t>(&stripes.stripe(i - 1));
+        EXPECT_GE(distance, utils::CACHE_LINE_SIZE);
+    }
+}
+
+TEST(TestStripedSafeMutex, TestSequentialKeysSpreadOverStripes) {
+    using Striped = concurrency::StripedSafeMutex<16>;
+    std::set<std::size_t> used;
+    for (auto key = 0; key < 256; ++key) {
+        const auto index = Striped::StripeFor(key);
+        ASSERT_LT(index, Striped::STRIPES);
+        EXPECT_EQ(index, Striped::StripeFor(key));
+        used.insert(index);
+    }
+    EXPECT_EQ(used.size(), Striped::STRIPES);
+    EXPECT_EQ(concurrency::StripedSafeMutex<1>::StripeFor(42), 0);
+}
+
+TEST(TestStripedSafeMutex, TestStripesAreOrderedByIndex) {
+    concurrency::StripedSafeMutex<4> stripes;
+    const auto& graph = concurrency::LockOrderGraph::instance();
+    // Without the checks and the sampler nobody orders the locks, the chain isn't recorded
+    const auto ordered = concurrency::RuntimeChecks::enabled() || concurrency::LockSampler::interval() != 0;
+    for (std::size_t i = 1; i < 4; ++i) {
+        EXPECT_EQ(graph.hasEdge(stripes.stripe(i - 1).id(), stripes.stripe(i).id()), ordered);
+    }
+}
+
+TEST(TestStripedSafeMutex, TestLockForCounters) {
+    concurrency::StripedSafeMutex<8> stripes;
+    constexpr auto keysCount = 64;
+    constexpr auto threadsCount = 4;
+    constexpr auto iterations = 10'000;
+    std::array<std::uint64_t, keysCount> counters{};
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&, i] {
+            for (auto j = 0; j < iterations; ++j) {
+                const auto key = (i + j) % keysCount;
+                const auto guard = stripes.lockFor(key);
+                ++counters[key];
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::uint64_t total = 0;
+    for (const auto counter : counters) {
+        total += counter;
+    }
+    EXPECT_EQ(total, threadsCount * iterations);
+}
+
+TEST(TestStripedSafeMutex, TestLockAllTransfers) {
+    concurrency::StripedSafeMutex<4> stripes;
+    constexpr auto accountsCount = 32;
+    constexpr std::int64_t initialBalance = 1000;
+    constexpr auto threadsCount = 4;
+    constexpr auto iterations = 5'000;
+    std::array<std::int64_t, accountsCount> balances{};
+    balances.fill(initialBalance);
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&, i] {
+            std::mt19937 random{ static_cast<std::uint32_t>(i) };
+            std::uniform_int_distribution<int> account{ 0, accountsCount - 1 };
+            for (auto j = 0; j < iterations; ++j) {
+                // The keys often share a stripe (or are equal), each stripe must still be taken once
+                const std::array keys{ account(random), account(random), account(random) };
+                const auto guard = stripes.lockAll(keys);
+                --balances[keys[0]];
+                ++balances[keys[1]];
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::int64_t total = 0;
+    for (const auto balance : balances) {
+        total += balance;
+    }
+    EXPECT_EQ(total, accountsCount * initialBalance);
+}
+
+TEST(TestStripedSafeMutex, TestLockAllHoldsEveryStripe) {
+    using Striped = concurrency::StripedSafeMutex<64>;
+    Striped stripes;
+    const std::array keys{ 1, 2, 3, 1000 };
+
+    const auto guard = stripes.lockAll(keys);
+    for (const auto key : keys) {
+        EXPECT_TRUE(guard.holds(Striped::StripeFor(key)));
+    }
+
+    std::thread other{[&] {
+        for (const auto key : keys) {
+            EXPECT_FALSE(stripes.mutexFor(key).try_lock());
+        }
+    }};
+    other.join();
+}
+
+#ifndef NDEBUG
+
+TEST(TestStripedSafeMutex, TestDescendingStripeOrderIsDetected) {
+    concurrency::StripedSafeMutex<8> stripes;
+    concurrency::LockStory lockStory;
+
+    // No other thread has taken the stripes in the opposite order, the index order alone is violated
+    stripes.stripe(5).lock(lockStory);
+    const auto result = stripes.stripe(3).tryLockFor(lockStory, std::chrono::milliseconds(1));
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.error(), concurrency::LockError::Deadlock);
+
+    EXPECT_TRUE(stripes.stripe(6).tryLock(lockStory).isOk());
+    stripes.stripe(6).unlock(lockStory);
+    stripes.stripe(5).unlock(lockStory);
+}
+
+#endif //! ifndef NDEBUG
@@ -2,6 +2,8 @@
 
 #include "include/concurrency/sync.h"
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -48,3 +50,61 @@ TEST(SyncTest, TestMutableAccess) {
         EXPECT_TRUE(foo.m_sValue.empty());
     });
 }
+
+TEST(SyncTest, TestCompactLayout) {
+    // The checked build adds a single stamp word in front of the value
+    static_assert(sizeof(concurrency::MutableSync<std::uint32_t>) <= 2 * sizeof(std::uint32_t));
+    static_assert(alignof(concurrency::CacheAlignedMutableSync<std::uint32_t>) == utils::CACHE_LINE_SIZE);
+    static_assert(sizeof(concurrency::CacheAlignedMutableSync<std::uint32_t>) == utils::CACHE_LINE_SIZE);
+}
+
+TEST(SyncTest, TestCacheAlignedMutableSync) {
+    std::array<concurrency::CacheAlignedMutableSync<std::uint64_t>, 4> counters{};
+
+    for (std::size_t i = 0; i < counters.size(); ++i) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&counters[i]) % utils::CACHE_LINE_SIZE, 0);
+        counters[i].accessMutable([i](std::uint64_t& value) { value = i; });
+    }
+
+    for (std::size_t i = 0; i < counters.size(); ++i) {
+        EXPECT_EQ(counters[i].getValue(), i);
+    }
+}
+
+TEST(SyncTest, TestConstAccess) {
+    concurrency::MutableSync<std::uint64_t> value{ std::uint64_t{ 1 } };
+    concurrency::CacheAlignedMutableSync<std::uint64_t> aligned{ std::uint64_t{ 2 } };
+    const auto& constValue = value;
+    const auto& constAligned = aligned;
+
+    constValue.accessImmutable([](const std::uint64_t& value) { EXPECT_EQ(value, 1); });
+    constAligned.accessImmutable([](const std::uint64_t& value) { EXPECT_EQ(value, 2); });
+    EXPECT_EQ(constValue.getValue(), 1);
+    EXPECT_EQ(constAligned.getValue(), 2);
+}
+
+TEST(SyncTest, TestStampsWrapAround) {
+    concurrency::MutableSync<std::uint64_t> value{ std::uint64_t{ 0 } };
+    constexpr auto accesses = 3 * std::numeric_limits<concurrency::DefaultSyncConfig::TimeStampType>::max();
+
+    for (auto i = 0; i < accesses; ++i) {
+        value.accessMutable([](std::uint64_t& value) { ++value; });
+        value.accessImmutable([](const std::uint64_t& value) { EXPECT_GT(value, 0); });
+    }
+    EXPECT_EQ(value.getValue(), accesses);
+}
+
+#ifndef NDEBUG
+
+TEST(SyncTest, TestReadInsideWriteIsDetected) {
+    concurrency::MutableSync<int> value{ 0 };
+
+    const auto readInsideWrite = [&value] {
+        value.accessMutable([&value](int& ) {
+            value.accessImmutable([](const int& ) {});
+        });
+    };
+    EXPECT_DEATH(readInsideWrite(), "PANIC");
+}
+
+#endif //! ifndef NDEBUG
@@ -0,0 +1,372 @@
+/**
+ * @brief atom-lockanalyze: offline analysis of a binary LockTracer trace.
+ * @details Rebuilds the lock order graph from the acquisitions of every thread and reports
+ *  - lock order cycles (potential deadlocks) with the thread and the time which first took every edge;
+ *  - the longest convoys: the largest number of threads waiting for one lock at the same time;
+ *  - the most contended locks by the total wait time;
+ *  - the time windows with the largest total wait time and the lock which caused most of it.
+ * The exit code is 0 for a clean trace, 1 for a usage or trace format error and 2 if a cycle is found.
+ * @example atom-lockanalyze /tmp/service.locktrace --top 5 --window-ms 100
+ */
+#include "include/concurrency/lock_tracer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using namespace atom::concurrency;
+
+using NodeType = std::size_t;
+
+struct Options final {
+    std::string path;
+    std::size_t top = 10;
+    std::uint64_t window = 10'000'000; // ns
+};
+
+struct EdgeWitness final {
+    std::uint32_t threadId;
+    std::uint64_t timestamp;
+};
+
+struct LockStats final {
+    std::uint64_t acquisitions = 0;
+    std::uint64_t contended = 0;
+    std::uint64_t totalWait = 0;
+    std::uint64_t maxWait = 0;
+    std::size_t maxWaiters = 0;
+    std::uint64_t maxWaitersAt = 0;
+};
+
+/**
+ * @brief Lock ids are reused after the Destroy event, so a node is an (id, generation) pair.
+ */
+class Trace final {
+public:
+    explicit Trace(std::vector<LockEvent> events): m_events(std::move(events)), m_nodes(), m_names(), m_generations() {
+        std::stable_sort(m_events.begin(), m_events.end(), [](const LockEvent& lhs, const LockEvent& rhs) {
+            return lhs.timestamp < rhs.timestamp;
+        });
+    }
+
+    const std::vector<LockEvent>& events() const { return m_events; }
+    std::uint64_t start() const { return m_events.empty() ? 0 : m_events.front().timestamp; }
+    std::size_t nodesCount() const { return m_names.size(); }
+    const std::string& name(const NodeType node) const { return m_names[node]; }
+
+    NodeType nodeOf(const std::uint32_t mutexId) {
+        const auto generation = m_generations[mutexId];
+        const auto key = (static_cast<std::uint64_t>(mutexId) << 32) | generation;
+        const auto [it, inserted] = m_nodes.try_emplace(key, m_names.size());
+        if (inserted) {
+            m_names.push_back("#" + std::to_string(mutexId) + (generation ? "." + std::to_string(generation) : ""));
+        }
+        return it->second;
+    }
+
+    void destroy(const std::uint32_t mutexId) { ++m_generations[mutexId]; }
+
+private:
+    std::vector<LockEvent> m_events;
+    std::unordered_map<std::uint64_t, NodeType> m_nodes;
+    std::vector<std::string> m_names;
+    std::unordered_map<std::uint32_t, std::uint32_t> m_generations;
+};
+
+std::string FormatDuration(const std::uint64_t ns) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (ns < 1'000) {
+        out << ns << "ns";
+    } else if (ns < 1'000'000) {
+        out << ns / 1e3 << "us";
+    } else if (ns < 1'000'000'000) {
+        out << ns / 1e6 << "ms";
+    } else {
+        out << ns / 1e9 << "s";
+    }
+    return out.str();
+}
+
+std::optional<Options> ParseOptions(const int argc, char** const argv) {
+    Options options;
+    for (auto i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--top" && i + 1 < argc) {
+            options.top = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--window-ms" && i + 1 < argc) {
+            options.window = std::strtoull(argv[++i], nullptr, 10) * 1'000'000;
+        } else if (options.path.empty() && !arg.starts_with("--")) {
+            options.path = arg;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    if (options.path.empty() || options.top == 0 || options.window == 0) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+std::optional<std::vector<LockEvent>> ReadTrace(const std::string& path) {
+    std::ifstream file{ path, std::ios::binary };
+    LockTraceHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != LockTraceHeader::MAGIC) {
+        std::cerr << path << ": not a lock trace" << std::endl;
+        return std::nullopt;
+    }
+
+    if (header.version != LockTraceHeader::VERSION || header.eventSize != sizeof(LockEvent)) {
+        std::cerr << path << ": unsupported trace version " << header.version << std::endl;
+        return std::nullopt;
+    }
+
+    if (header.size > header.capacity) {
+        std::cerr << "warning: " << header.size - header.capacity << " events were dropped, the trace is full" << std::endl;
+    }
+
+    // A trace of a crashed process can be shorter than the header claims
+    std::vector<LockEvent> events(std::min(header.size, header.capacity));
+    file.read(reinterpret_cast<char*>(events.data()), static_cast<std::streamsize>(events.size() * sizeof(LockEvent)));
+    events.resize(static_cast<std::size_t>(file.gcount()) / sizeof(LockEvent));
+    return events;
+}
+
+/**
+ * @brief Finds one cycle in every non-trivial strongly connected component (Tarjan).
+ */
+std::vector<std::vector<NodeType>> FindCycles(const std::vector<std::vector<NodeType>>& edges) {
+    const auto size = edges.size();
+    std::vector<std::size_t> index(size, SIZE_MAX);
+    std::vector<std::size_t> lowLink(size, 0);
+    std::vector<bool> onStack(size, false);
+    std::vector<NodeType> stack;
+    std::vector<std::size_t> component(size, SIZE_MAX);
+    std::vector<std::vector<NodeType>> components;
+    std::size_t nextIndex = 0;
+
+    std::function<void(NodeType)> connect = [&](const NodeType node) {
+        index[node] = lowLink[node] = nextIndex++;
+        stack.push_back(node);
+        onStack[node] = true;
+        for (const auto next : edges[node]) {
+            if (index[next] == SIZE_MAX) {
+                connect(next);
+                lowLink[node] = std::min(lowLink[node], lowLink[next]);
+            } else if (onStack[next]) {
+                lowLink[node] = std::min(lowLink[node], index[next]);
+            }
+        }
+
+        if (lowLink[node] == index[node]) {
+            std::vector<NodeType> members;
+            NodeType member = 0;
+            do {
+                member = stack.back();
+                stack.pop_back();
+                onStack[member] = false;
+                component[member] = components.size();
+                members.push_back(member);
+            } while (member != node);
+            components.push_back(std::move(members));
+        }
+    };
+
+    for (NodeType node = 0; node < size; ++node) {
+        if (index[node] == SIZE_MAX) {
+            connect(node);
+        }
+    }
+
+    std::vector<std::vector<NodeType>> cycles;
+    for (std::size_t c = 0; c < components.size(); ++c) {
+        if (components[c].size() < 2) {
+            continue;
+        }
+
+        // BFS inside the component from its first member back to itself gives the shortest cycle through it
+        const auto root = components[c].front();
+        std::unordered_map<NodeType, NodeType> parent;
+        std::vector<NodeType> queue{ root };
+        std::optional<NodeType> last;
+        for (std::size_t i = 0; i < queue.size() && !last; ++i) {
+            for (const auto next : edges[queue[i]]) {
+                if (component[next] != c) {
+                    continue;
+                }
+                if (next == root) {
+                    last = queue[i];
+                    break;
+                }
+                if (parent.try_emplace(next, queue[i]).second) {
+                    queue.push_back(next);
+                }
+            }
+        }
+
+        std::vector<NodeType> cycle;
+        for (auto node = *last; node != root; node = parent[node]) {
+            cycle.push_back(node);
+        }
+        cycle.push_back(root);
+        std::reverse(cycle.begin(), cycle.end());
+        cycles.push_back(std::move(cycle));
+    }
+
+    return cycles;
+}
+
+} //! namespace
+
+int main(const int argc, char** const argv) {
+    const auto options = ParseOptions(argc, argv);
+    if (!options) {
+        std::cerr << "usage: " << argv[0] << " <trace-file> [--top N] [--window-ms MS]" << std::endl;
+        return 1;
+    }
+
+    auto events = ReadTrace(options->path);
+    if (!events) {
+        return 1;
+    }
+
+    Trace trace{ std::move(*events) };
+    std::unordered_map<std::uint32_t, std::vector<NodeType>> held;
+    std::map<std::pair<NodeType, NodeType>, EdgeWitness> witnesses;
+    std::vector<LockStats> stats;
+    std::vector<std::vector<std::pair<std::uint64_t, int>>> waits; // (time, +1 wait starts / -1 wait ends)
+    std::map<std::uint64_t, std::unordered_map<NodeType, std::uint64_t>> windows;
+
+    for (const auto& event : trace.events()) {
+        if (event.type == LockEventType::Destroy) {
+            trace.destroy(event.mutexId);
+            continue;
+        }
+
+        const auto node = trace.nodeOf(event.mutexId);
+        stats.resize(trace.nodesCount());
+        waits.resize(trace.nodesCount());
+        auto& threadHeld = held[event.threadId];
+        if (event.type == LockEventType::Release) {
+            if (const auto it = std::find(threadHeld.rbegin(), threadHeld.rend(), node); it != threadHeld.rend()) {
+                threadHeld.erase(std::next(it).base());
+            }
+            continue;
+        }
+
+        for (const auto from : threadHeld) {
+            witnesses.try_emplace({ from, node }, EdgeWitness{ event.threadId, event.timestamp });
+        }
+        threadHeld.push_back(node);
+
+        auto& lockStats = stats[node];
+        ++lockStats.acquisitions;
+        if (event.waitTime != 0) {
+            ++lockStats.contended;
+            lockStats.totalWait += event.waitTime;
+            lockStats.maxWait = std::max<std::uint64_t>(lockStats.maxWait, event.waitTime);
+            waits[node].emplace_back(event.timestamp - event.waitTime, 1);
+            waits[node].emplace_back(event.timestamp, -1);
+            windows[(event.timestamp - trace.start()) / options->window][node] += event.waitTime;
+        }
+    }
+
+    std::cout << trace.events().size() << " events, " << trace.nodesCount() << " locks, " << held.size() << " threads, "
+        << witnesses.size() << " lock order edges" << std::endl;
+
+    // Lock order cycles
+    std::vector<std::vector<NodeType>> edges(trace.nodesCount());
+    for (const auto& [edge, witness] : witnesses) {
+        edges[edge.first].push_back(edge.second);
+    }
+
+    const auto cycles = FindCycles(edges);
+    std::cout << "\nLock order cycles: " << cycles.size() << std::endl;
+    for (const auto& cycle : cycles) {
+        std::cout << "  ";
+        for (std::size_t i = 0; i < cycle.size(); ++i) {
+            const auto from = cycle[i];
+            const auto to = cycle[(i + 1) % cycle.size()];
+            const auto& witness = witnesses.at({ from, to });
+            std::cout << trace.name(from) << " -> " << trace.name(to) << " (thread " << witness.threadId << " at +"
+                << FormatDuration(witness.timestamp - trace.start()) << ")" << (i + 1 < cycle.size() ? ", " : "");
+        }
+        std::cout << std::endl;
+    }
+
+    // Convoys: the largest number of overlapping waits on one lock
+    for (NodeType node = 0; node < waits.size(); ++node) {
+        auto& points = waits[node];
+        std::sort(points.begin(), points.end());
+        std::size_t depth = 0;
+        for (const auto& [time, delta] : points) {
+            depth += delta;
+            if (depth > stats[node].maxWaiters) {
+                stats[node].maxWaiters = depth;
+                stats[node].maxWaitersAt = time;
+            }
+        }
+    }
+
+    std::vector<NodeType> nodes(trace.nodesCount());
+    for (NodeType node = 0; node < nodes.size(); ++node) {
+        nodes[node] = node;
+    }
+
+    const auto printTop = [&](const std::string& title, auto key, auto print) {
+        std::sort(nodes.begin(), nodes.end(), [&](const NodeType lhs, const NodeType rhs) { return key(lhs) > key(rhs); });
+        std::cout << "\n" << title << ":" << std::endl;
+        for (std::size_t i = 0; i < std::min(options->top, nodes.size()) && key(nodes[i]) != 0; ++i) {
+            std::cout << "  " << trace.name(nodes[i]) << ": ";
+            print(nodes[i]);
+            std::cout << std::endl;
+        }
+    };
+
+    printTop("Worst convoys", [&](const NodeType node) { return stats[node].maxWaiters; }, [&](const NodeType node) {
+        std::cout << stats[node].maxWaiters << " waiting threads at +" << FormatDuration(stats[node].maxWaitersAt - trace.start());
+    });
+
+    printTop("Most contended locks", [&](const NodeType node) { return stats[node].totalWait; }, [&](const NodeType node) {
+        const auto& lockStats = stats[node];
+        std::cout << "waited " << FormatDuration(lockStats.totalWait) << " in " << lockStats.contended << " of "
+            << lockStats.acquisitions << " acquisitions, max " << FormatDuration(lockStats.maxWait);
+    });
+
+    // Contention windows
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> windowTotals; // (total wait, window)
+    for (const auto& [window, perLock] : windows) {
+        std::uint64_t total = 0;
+        for (const auto& [node, wait] : perLock) {
+            total += wait;
+        }
+        windowTotals.emplace_back(total, window);
+    }
+    std::sort(windowTotals.rbegin(), windowTotals.rend());
+
+    std::cout << "\nWorst " << FormatDuration(options->window) << " contention windows:" << std::endl;
+    for (std::size_t i = 0; i < std::min(options->top, windowTotals.size()); ++i) {
+        const auto [total, window] = windowTotals[i];
+        const auto& perLock = windows.at(window);
+        const auto worst = std::max_element(perLock.cbegin(), perLock.cend(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second < rhs.second;
+        });
+        std::cout << "  +" << FormatDuration(window * options->window) << ": waited " << FormatDuration(total)
+            << ", mostly on " << trace.name(worst->first) << " (" << FormatDuration(worst->second) << ")" << std::endl;
+    }
+
+    return cycles.empty() ? 0 : 2;
+}